@@ -1,6 +1,7 @@
 ﻿#include "Automaton.h"
-#include <QQueue>
 #include <QDebug>
+#include <QHash>
+#include <QPair>
 #include <algorithm>
 
 Automaton::Automaton()
@@ -17,6 +18,7 @@ bool Automaton::addState(const State& state) {
         }
     }
     states.push_back(state);
+    invalidateTopology();
 
     if (state.getIsInitial()) {
         initialStateId = state.getId();
@@ -26,6 +28,7 @@ bool Automaton::addState(const State& state) {
 }
 
 bool Automaton::removeState(const QString& stateId) {
+    invalidateTopology();
     transitions.erase(
         std::remove_if(transitions.begin(), transitions.end(),
                        [&stateId](const Transition& t) {
@@ -50,6 +53,7 @@ bool Automaton::removeState(const QString& stateId) {
 }
 
 State* Automaton::getState(const QString& stateId) {
+    invalidateTopology();
     for (auto& state : states) {
         if (state.getId() == stateId) {
             return &state;
@@ -121,6 +125,7 @@ bool Automaton::addTransition(const Transition& transition) {
         qDebug() << "Cannot add transition:" << errorMsg;
         return false;
     }
+    invalidateTopology();
 
     for (auto& t : transitions) {
         if (t.getFromStateId() == transition.getFromStateId() &&
@@ -149,6 +154,7 @@ bool Automaton::addTransition(const Transition& transition) {
 }
 
 bool Automaton::removeTransition(const QString& from, const QString& to, const QString& symbol) {
+    invalidateTopology();
     for (auto it = transitions.begin(); it != transitions.end(); ++it) {
         if (it->getFromStateId() == from && it->getToStateId() == to) {
             if (symbol.isEmpty()) {
@@ -177,6 +183,7 @@ QVector<Transition> Automaton::getTransitionsFrom(const QString& stateId) const
 }
 
 void Automaton::setInitialState(const QString& stateId) {
+    invalidateTopology();
     for (auto& state : states) {
         state.setIsInitial(false);
     }
@@ -227,18 +234,15 @@ void Automaton::detectType() {
         }
     }
 
-    for (const auto& state : states) {
-        QMap<QString, int> symbolCount;
-        for (const auto& t : transitions) {
-            if (t.getFromStateId() == state.getId()) {
-                for (const auto& sym : t.getSymbols()) {
-                    symbolCount[sym]++;
-                    if (symbolCount[sym] > 1) {
-                        type = AutomatonType::NFA;
-                        return;
-                    }
-                }
+    QSet<QPair<QString, QString>> moves;
+    for (const auto& t : transitions) {
+        for (const auto& sym : t.getSymbols()) {
+            QPair<QString, QString> move = qMakePair(t.getFromStateId(), sym);
+            if (moves.contains(move)) {
+                type = AutomatonType::NFA;
+                return;
             }
+            moves.insert(move);
         }
     }
 
@@ -246,35 +250,35 @@ void Automaton::detectType() {
 }
 
  
-QSet<QString> Automaton::epsilonClosureHelper(const QString& stateId) const {
-    QSet<QString> closure;
-    QQueue<QString> queue;
-
-    closure.insert(stateId);
-    queue.enqueue(stateId);
-
-    while (!queue.isEmpty()) {
-        QString current = queue.dequeue();
-
-        for (const auto& t : transitions) {
-            if (t.getFromStateId() == current && t.isEpsilonTransition()) {
-                if (!closure.contains(t.getToStateId())) {
-                    closure.insert(t.getToStateId());
-                    queue.enqueue(t.getToStateId());
-                }
-            }
-        }
+QSharedPointer<const AutomatonTopology> Automaton::getTopology() const {
+    if (!topology) {
+        topology = QSharedPointer<const AutomatonTopology>(
+            new AutomatonTopology(states, transitions, initialStateId));
     }
-
-    return closure;
+    return topology;
 }
 
 QSet<QString> Automaton::epsilonClosure(const QSet<QString>& stateIds) const {
-    QSet<QString> closure;
+    QSharedPointer<const AutomatonTopology> graph = getTopology();
+    QVector<bool> member(graph->getStateCount(), false);
+    QVector<int> closure;
+    QSet<QString> result;
+
     for (const auto& id : stateIds) {
-        closure.unite(epsilonClosureHelper(id));
+        int state = graph->indexOf(id);
+        if (state == AutomatonTopology::NO_STATE) {
+            result.insert(id);
+        } else if (!member[state]) {
+            member[state] = true;
+            closure.append(state);
+        }
+    }
+
+    graph->epsilonClosure(closure, member);
+    for (int state : closure) {
+        result.insert(graph->getStateId(state));
     }
-    return closure;
+    return result;
 }
 
  
@@ -291,56 +295,62 @@ bool Automaton::accepts(const QString& input) const {
 }
 
 bool Automaton::acceptsDFA(const QString& input) const {
-    QString currentState = initialStateId;
+    QSharedPointer<const AutomatonTopology> graph = getTopology();
+    int state = graph->getInitialState();
 
     for (const QChar& ch : input) {
-        QString symbol = QString(ch);
-        bool found = false;
-
-        for (const auto& t : transitions) {
-            if (t.getFromStateId() == currentState && t.hasSymbol(symbol)) {
-                currentState = t.getToStateId();
-                found = true;
-                break;
-            }
+        int symbol = graph->symbolOf(ch);
+        if (symbol <= AutomatonTopology::EPSILON) {
+            return false;
         }
-
-        if (!found) {
+        state = graph->step(state, symbol);
+        if (state == AutomatonTopology::NO_STATE) {
             return false;
         }
     }
 
-    const State* state = getState(currentState);
-    return state && state->getIsFinal();
+    return graph->isFinal(state);
 }
 
 bool Automaton::acceptsNFA(const QString& input) const {
-    QSet<QString> currentStates;
-    currentStates.insert(initialStateId);
-    currentStates = epsilonClosure(currentStates);
+    QSharedPointer<const AutomatonTopology> graph = getTopology();
+    QVector<bool> member(graph->getStateCount(), false);
+    QVector<int> current;
+    QVector<int> next;
+
+    current.append(graph->getInitialState());
+    member[graph->getInitialState()] = true;
+    graph->epsilonClosure(current, member);
 
     for (const QChar& ch : input) {
-        QString symbol = QString(ch);
-        QSet<QString> nextStates;
+        int symbol = graph->symbolOf(ch);
+        for (int state : current) {
+            member[state] = false;
+        }
+        if (symbol <= AutomatonTopology::EPSILON) {
+            return false;
+        }
 
-        for (const auto& stateId : currentStates) {
-            for (const auto& t : transitions) {
-                if (t.getFromStateId() == stateId && t.hasSymbol(symbol)) {
-                    nextStates.insert(t.getToStateId());
+        next.clear();
+        for (int state : current) {
+            for (int e = graph->edgeBegin(state); e < graph->edgeEnd(state); ++e) {
+                int target = graph->edgeTarget(e);
+                if (graph->edgeSymbol(e) == symbol && !member[target]) {
+                    member[target] = true;
+                    next.append(target);
                 }
             }
         }
+        graph->epsilonClosure(next, member);
 
-        currentStates = epsilonClosure(nextStates);
-
-        if (currentStates.isEmpty()) {
+        if (next.isEmpty()) {
             return false;
         }
+        current.swap(next);
     }
 
-    for (const auto& stateId : currentStates) {
-        const State* state = getState(stateId);
-        if (state && state->getIsFinal()) {
+    for (int state : current) {
+        if (graph->isFinal(state)) {
             return true;
         }
     }
@@ -349,8 +359,81 @@ bool Automaton::acceptsNFA(const QString& input) const {
 }
 
 void Automaton::clear() {
+    invalidateTopology();
     states.clear();
     transitions.clear();
     alphabet.clear();
     initialStateId = "";
 }
+
+bool Automaton::loadBulk(QVector<State> newStates, QVector<Transition> newTransitions, QString* errorMsg) {
+    QSet<QString> ids;
+    ids.reserve(newStates.size());
+    QString initial;
+
+    for (const auto& state : newStates) {
+        if (ids.contains(state.getId())) {
+            qDebug() << "Cannot load automaton: duplicate state" << state.getId();
+            if (errorMsg) *errorMsg = QString("Duplicate state '%1'.").arg(state.getId());
+            return false;
+        }
+        ids.insert(state.getId());
+        if (state.getIsInitial()) {
+            initial = state.getId();
+        }
+    }
+
+    QHash<QPair<QString, QString>, int> edgeIndex;
+    QSet<QPair<QString, QString>> moves;
+    QVector<Transition> merged;
+    QSet<QString> symbols;
+    edgeIndex.reserve(newTransitions.size());
+    merged.reserve(newTransitions.size());
+
+    for (const auto& t : newTransitions) {
+        if (!ids.contains(t.getFromStateId()) || !ids.contains(t.getToStateId())) {
+            qDebug() << "Cannot load automaton: transition references a missing state";
+            if (errorMsg) {
+                *errorMsg = QString("Transition %1 -> %2 references a missing state.")
+                                .arg(t.getFromStateId()).arg(t.getToStateId());
+            }
+            return false;
+        }
+
+        for (const auto& sym : t.getSymbols()) {
+            bool epsilon = sym == "E" || sym == "ε" || sym == "epsilon" || sym.isEmpty();
+            if (type == AutomatonType::DFA) {
+                QPair<QString, QString> move = qMakePair(t.getFromStateId(), sym);
+                if (epsilon || moves.contains(move)) {
+                    qDebug() << "Cannot load automaton: not deterministic at state" << t.getFromStateId();
+                    if (errorMsg) {
+                        *errorMsg = QString("State '%1' is not deterministic on '%2'.").arg(t.getFromStateId()).arg(sym);
+                    }
+                    return false;
+                }
+                moves.insert(move);
+            }
+            if (!epsilon) {
+                symbols.insert(sym);
+            }
+        }
+
+        QPair<QString, QString> key = qMakePair(t.getFromStateId(), t.getToStateId());
+        int index = edgeIndex.value(key, -1);
+        if (index < 0) {
+            edgeIndex.insert(key, merged.size());
+            merged.append(t);
+        } else {
+            for (const auto& sym : t.getSymbols()) {
+                merged[index].addSymbol(sym);
+            }
+        }
+    }
+
+    states = std::move(newStates);
+    transitions = std::move(merged);
+    invalidateTopology();
+    alphabet = symbols;
+    initialStateId = initial;
+    return true;
+}
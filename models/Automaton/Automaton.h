@@ -3,6 +3,8 @@
 
 #include "State.h"
 #include "Transition.h"
+#include "AutomatonTopology.h"
+#include <QSharedPointer>
 #include <QVector>
 #include <QMap>
 #include <QString>
@@ -22,6 +24,7 @@ private:
     QVector<Transition> transitions;
     QSet<QString> alphabet;
     QString initialStateId;
+    mutable QSharedPointer<const AutomatonTopology> topology;
 
 public:
     Automaton();
@@ -32,7 +35,7 @@ public:
     bool removeState(const QString& stateId);
     State* getState(const QString& stateId);
     const State* getState(const QString& stateId) const;
-    QVector<State>& getStates() { return states; }
+    QVector<State>& getStates() { invalidateTopology(); return states; }
     const QVector<State>& getStates() const { return states; }
 
 
@@ -40,7 +43,7 @@ public:
     bool canAddTransition(const Transition& transition, QString* errorMsg = nullptr) const;
     bool removeTransition(const QString& from, const QString& to, const QString& symbol);
     QVector<Transition> getTransitionsFrom(const QString& stateId) const;
-    QVector<Transition>& getTransitions() { return transitions; }
+    QVector<Transition>& getTransitions() { invalidateTopology(); return transitions; }
     const QVector<Transition>& getTransitions() const { return transitions; }
 
 
@@ -70,11 +73,13 @@ public:
 
 
     void clear();
+    bool loadBulk(QVector<State> newStates, QVector<Transition> newTransitions, QString* errorMsg = nullptr);
     int getStateCount() const { return states.size(); }
     int getTransitionCount() const { return transitions.size(); }
+    QSharedPointer<const AutomatonTopology> getTopology() const;
 
 private:
-    QSet<QString> epsilonClosureHelper(const QString& stateId) const;
+    void invalidateTopology() { topology.clear(); }
     bool acceptsNFA(const QString& input) const;
     bool acceptsDFA(const QString& input) const;
 };
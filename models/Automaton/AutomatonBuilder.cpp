@@ -0,0 +1,53 @@
+#include "AutomatonBuilder.h"
+
+AutomatonBuilder::AutomatonBuilder(const QString& id, const QString& name, AutomatonType type)
+    : id(id), name(name), type(type) {}
+
+void AutomatonBuilder::reserve(int stateCount, int transitionCount) {
+    states.reserve(stateCount);
+    transitions.reserve(transitionCount);
+}
+
+void AutomatonBuilder::addStates(const QVector<State>& newStates) {
+    states.reserve(states.size() + newStates.size());
+    for (const auto& state : newStates) {
+        states.append(state);
+    }
+}
+
+void AutomatonBuilder::addTransition(const QString& from, const QString& to, const QString& symbol) {
+    transitions.append(Transition(from, to, symbol));
+}
+
+void AutomatonBuilder::addTransitions(const QVector<Transition>& newTransitions) {
+    transitions.reserve(transitions.size() + newTransitions.size());
+    for (const auto& transition : newTransitions) {
+        transitions.append(transition);
+    }
+}
+
+
+bool AutomatonBuilder::finish(Automaton& automaton, QString* errorMsg) {
+    automaton = Automaton(id, name, type);
+    bool loaded = automaton.loadBulk(std::move(states), std::move(transitions), errorMsg);
+
+    if (loaded) {
+        for (const auto& symbol : alphabet) {
+            automaton.addToAlphabet(symbol);
+        }
+    }
+
+    states = QVector<State>();
+    transitions = QVector<Transition>();
+    alphabet.clear();
+    return loaded;
+}
+
+Automaton* AutomatonBuilder::finish(QString* errorMsg) {
+    Automaton* automaton = new Automaton();
+    if (!finish(*automaton, errorMsg)) {
+        delete automaton;
+        return nullptr;
+    }
+    return automaton;
+}
@@ -0,0 +1,46 @@
+#ifndef AUTOMATONBUILDER_H
+#define AUTOMATONBUILDER_H
+
+#include "Automaton.h"
+#include <QVector>
+#include <QString>
+#include <QSet>
+
+class AutomatonBuilder {
+private:
+    QString id;
+    QString name;
+    AutomatonType type;
+    QVector<State> states;
+    QVector<Transition> transitions;
+    QSet<QString> alphabet;
+
+public:
+    AutomatonBuilder(const QString& id, const QString& name, AutomatonType type);
+
+
+    void reserve(int stateCount, int transitionCount);
+
+    void addState(const State& state) { states.append(state); }
+    void addState(State&& state) { states.append(std::move(state)); }
+    void addStates(const QVector<State>& newStates);
+
+    void addTransition(const Transition& transition) { transitions.append(transition); }
+    void addTransition(Transition&& transition) { transitions.append(std::move(transition)); }
+    void addTransition(const QString& from, const QString& to, const QString& symbol);
+    void addTransitions(const QVector<Transition>& newTransitions);
+
+    void addToAlphabet(const QString& symbol) { alphabet.insert(symbol); }
+
+
+    QString getName() const { return name; }
+    void setName(const QString& n) { name = n; }
+    int getStateCount() const { return states.size(); }
+    int getTransitionCount() const { return transitions.size(); }
+
+
+    bool finish(Automaton& automaton, QString* errorMsg = nullptr);
+    Automaton* finish(QString* errorMsg = nullptr);
+};
+
+#endif
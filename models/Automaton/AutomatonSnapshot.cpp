@@ -0,0 +1,26 @@
+#include "AutomatonSnapshot.h"
+
+AutomatonSnapshot::AutomatonSnapshot(const Automaton& automaton, quint64 revision)
+    : automaton(automaton), topology(this->automaton.getTopology()), revision(revision) {}
+
+
+AutomatonSnapshotPublisher::AutomatonSnapshotPublisher() : revision(0) {}
+
+std::shared_ptr<const AutomatonSnapshot> AutomatonSnapshotPublisher::publish(const Automaton& automaton) {
+    automaton.getTopology();
+    quint64 next = revision.fetch_add(1, std::memory_order_acq_rel) + 1;
+    std::shared_ptr<const AutomatonSnapshot> published =
+        std::make_shared<const AutomatonSnapshot>(automaton, next);
+
+    std::atomic_store_explicit(&snapshot, published, std::memory_order_release);
+    return published;
+}
+
+std::shared_ptr<const AutomatonSnapshot> AutomatonSnapshotPublisher::current() const {
+    return std::atomic_load_explicit(&snapshot, std::memory_order_acquire);
+}
+
+void AutomatonSnapshotPublisher::clear() {
+    std::atomic_store_explicit(&snapshot, std::shared_ptr<const AutomatonSnapshot>(),
+                               std::memory_order_release);
+}
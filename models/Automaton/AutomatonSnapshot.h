@@ -0,0 +1,52 @@
+#ifndef AUTOMATONSNAPSHOT_H
+#define AUTOMATONSNAPSHOT_H
+
+#include "Automaton.h"
+#include <QSharedPointer>
+#include <QString>
+#include <QSet>
+#include <atomic>
+#include <memory>
+
+class AutomatonSnapshot {
+private:
+    const Automaton automaton;
+    QSharedPointer<const AutomatonTopology> topology;
+    quint64 revision;
+
+public:
+    AutomatonSnapshot(const Automaton& automaton, quint64 revision);
+
+
+    const Automaton& getAutomaton() const { return automaton; }
+    const AutomatonTopology& getTopology() const { return *topology; }
+    quint64 getRevision() const { return revision; }
+
+    QString getName() const { return automaton.getName(); }
+    AutomatonType getType() const { return automaton.getType(); }
+
+
+    bool accepts(const QString& input) const { return automaton.accepts(input); }
+    QSet<QString> epsilonClosure(const QSet<QString>& stateIds) const { return automaton.epsilonClosure(stateIds); }
+};
+
+
+class AutomatonSnapshotPublisher {
+private:
+    std::shared_ptr<const AutomatonSnapshot> snapshot;
+    std::atomic<quint64> revision;
+
+public:
+    AutomatonSnapshotPublisher();
+    AutomatonSnapshotPublisher(const AutomatonSnapshotPublisher&) = delete;
+    AutomatonSnapshotPublisher& operator=(const AutomatonSnapshotPublisher&) = delete;
+
+
+    std::shared_ptr<const AutomatonSnapshot> publish(const Automaton& automaton);
+    std::shared_ptr<const AutomatonSnapshot> current() const;
+    void clear();
+
+    quint64 getRevision() const { return revision.load(std::memory_order_acquire); }
+};
+
+#endif
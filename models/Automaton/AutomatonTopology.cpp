@@ -0,0 +1,148 @@
+#include "AutomatonTopology.h"
+#include <algorithm>
+
+AutomatonTopology::AutomatonTopology() : initial(NO_STATE), epsilonEdges(0) {
+    symbols.append(QString("E"));
+    offsets.append(0);
+}
+
+AutomatonTopology::AutomatonTopology(const QVector<State>& states, const QVector<Transition>& transitions,
+                                     const QString& initialStateId)
+    : AutomatonTopology() {
+    int n = states.size();
+    flags.reserve(n);
+    stateIds.reserve(n);
+    stateIndex.reserve(n);
+
+    for (const auto& state : states) {
+        if (stateIndex.contains(state.getId())) {
+            continue;
+        }
+        stateIndex.insert(state.getId(), stateIds.size());
+        stateIds.append(state.getId());
+        flags.append(quint8((state.getIsInitial() ? Initial : 0) | (state.getIsFinal() ? Final : 0)));
+    }
+    n = stateIds.size();
+    initial = indexOf(initialStateId);
+
+
+    QVector<qint64> edges;
+    edges.reserve(transitions.size());
+    QVector<int> sources;
+    sources.reserve(transitions.size());
+
+    for (const auto& t : transitions) {
+        int from = indexOf(t.getFromStateId());
+        int to = indexOf(t.getToStateId());
+        if (from == NO_STATE || to == NO_STATE) {
+            continue;
+        }
+        for (const auto& symbol : t.getSymbols()) {
+            edges.append((qint64(internSymbol(symbol)) << 32) | to);
+            sources.append(from);
+        }
+    }
+
+    offsets = QVector<int>(n + 1, 0);
+    for (int from : sources) {
+        offsets[from + 1]++;
+    }
+    for (int s = 0; s < n; ++s) {
+        offsets[s + 1] += offsets[s];
+    }
+
+    QVector<qint64> sorted(edges.size());
+    QVector<int> cursor = offsets;
+    for (int e = 0; e < edges.size(); ++e) {
+        sorted[cursor[sources[e]]++] = edges[e];
+    }
+
+    targets.reserve(sorted.size());
+    edgeSymbols.reserve(sorted.size());
+    for (int s = 0; s < n; ++s) {
+        std::sort(sorted.begin() + offsets[s], sorted.begin() + offsets[s + 1]);
+        for (int e = offsets[s]; e < offsets[s + 1]; ++e) {
+            int symbol = int(sorted[e] >> 32);
+            targets.append(int(sorted[e] & 0xffffffff));
+            edgeSymbols.append(symbol);
+            if (symbol == EPSILON) {
+                epsilonEdges++;
+            }
+        }
+    }
+}
+
+bool AutomatonTopology::isEpsilon(const QString& symbol) {
+    return symbol == "E" || symbol == "ε" || symbol == "epsilon" || symbol.isEmpty();
+}
+
+int AutomatonTopology::internSymbol(const QString& symbol) {
+    if (isEpsilon(symbol)) {
+        return EPSILON;
+    }
+
+    int index = symbolIndex.value(symbol, -1);
+    if (index < 0) {
+        index = symbols.size();
+        symbols.append(symbol);
+        symbolIndex.insert(symbol, index);
+        if (symbol.length() == 1) {
+            charSymbols.insert(symbol[0].unicode(), index);
+        }
+    }
+    return index;
+}
+
+int AutomatonTopology::symbolOf(const QString& symbol) const {
+    if (isEpsilon(symbol)) {
+        return EPSILON;
+    }
+    return symbolIndex.value(symbol, -1);
+}
+
+int AutomatonTopology::step(int state, int symbol) const {
+    auto begin = edgeSymbols.begin() + offsets[state];
+    auto end = edgeSymbols.begin() + offsets[state + 1];
+    auto it = std::lower_bound(begin, end, symbol);
+    if (it == end || *it != symbol) {
+        return NO_STATE;
+    }
+    return targets[int(it - edgeSymbols.begin())];
+}
+
+void AutomatonTopology::epsilonClosure(QVector<int>& states, QVector<bool>& member) const {
+    if (epsilonEdges == 0) {
+        return;
+    }
+
+    for (int i = 0; i < states.size(); ++i) {
+        int state = states[i];
+        for (int e = offsets[state]; e < offsets[state + 1] && edgeSymbols[e] == EPSILON; ++e) {
+            int target = targets[e];
+            if (!member[target]) {
+                member[target] = true;
+                states.append(target);
+            }
+        }
+    }
+}
+
+QVector<bool> AutomatonTopology::reachableFrom(int state) const {
+    QVector<bool> reached(getStateCount(), false);
+    if (state == NO_STATE) {
+        return reached;
+    }
+
+    QVector<int> queue;
+    queue.append(state);
+    reached[state] = true;
+    for (int i = 0; i < queue.size(); ++i) {
+        for (int e = offsets[queue[i]]; e < offsets[queue[i] + 1]; ++e) {
+            if (!reached[targets[e]]) {
+                reached[targets[e]] = true;
+                queue.append(targets[e]);
+            }
+        }
+    }
+    return reached;
+}
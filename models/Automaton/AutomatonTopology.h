@@ -0,0 +1,72 @@
+#ifndef AUTOMATONTOPOLOGY_H
+#define AUTOMATONTOPOLOGY_H
+
+#include "State.h"
+#include "Transition.h"
+#include <QVector>
+#include <QHash>
+#include <QString>
+#include <QChar>
+
+class AutomatonTopology {
+public:
+    static constexpr int EPSILON = 0;
+    static constexpr int NO_STATE = -1;
+
+    enum StateFlag : quint8 {
+        Initial = 1,
+        Final = 2
+    };
+
+    AutomatonTopology();
+    AutomatonTopology(const QVector<State>& states, const QVector<Transition>& transitions,
+                      const QString& initialStateId);
+
+
+    int getStateCount() const { return flags.size(); }
+    int getInitialState() const { return initial; }
+    bool isFinal(int state) const { return flags[state] & Final; }
+    bool isInitial(int state) const { return flags[state] & Initial; }
+
+    int indexOf(const QString& stateId) const { return stateIndex.value(stateId, NO_STATE); }
+    const QString& getStateId(int state) const { return stateIds[state]; }
+
+
+    int getSymbolCount() const { return symbols.size(); }
+    int symbolOf(const QString& symbol) const;
+    int symbolOf(QChar c) const { return charSymbols.value(c.unicode(), -1); }
+    const QString& getSymbol(int symbol) const { return symbols[symbol]; }
+    bool hasEpsilonEdges() const { return epsilonEdges > 0; }
+
+
+    int getEdgeCount() const { return targets.size(); }
+    int edgeBegin(int state) const { return offsets[state]; }
+    int edgeEnd(int state) const { return offsets[state + 1]; }
+    int edgeTarget(int edge) const { return targets[edge]; }
+    int edgeSymbol(int edge) const { return edgeSymbols[edge]; }
+    int step(int state, int symbol) const;
+
+
+    void epsilonClosure(QVector<int>& states, QVector<bool>& member) const;
+    QVector<bool> reachableFrom(int state) const;
+
+private:
+    QVector<quint8> flags;
+    QVector<QString> stateIds;
+    QHash<QString, int> stateIndex;
+    int initial;
+
+    QVector<QString> symbols;
+    QHash<QString, int> symbolIndex;
+    QHash<ushort, int> charSymbols;
+
+    QVector<int> offsets;
+    QVector<int> targets;
+    QVector<int> edgeSymbols;
+    int epsilonEdges;
+
+    int internSymbol(const QString& symbol);
+    static bool isEpsilon(const QString& symbol);
+};
+
+#endif
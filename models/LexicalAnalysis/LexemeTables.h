@@ -0,0 +1,156 @@
+#ifndef LEXEMETABLES_H
+#define LEXEMETABLES_H
+
+#include "Token.h"
+#include <QChar>
+#include <cstdint>
+
+constexpr std::uint32_t lexemeUnit(char c) { return static_cast<unsigned char>(c); }
+constexpr std::uint32_t lexemeUnit(char16_t c) { return c; }
+constexpr std::uint32_t lexemeUnit(QChar c) { return c.unicode(); }
+constexpr std::uint32_t foldCase(std::uint32_t c) { return (c - 'A' < 26) ? (c | 0x20) : c; }
+
+constexpr const char* const KEYWORDS[] = {
+    "if", "else", "while", "for", "do", "switch", "case", "default",
+    "break", "continue", "return", "void", "int", "float", "double",
+    "char", "bool", "true", "false", "const", "static", "class",
+    "public", "private", "protected", "struct", "enum", "string"
+};
+
+
+struct KeywordHash {
+    static constexpr int SLOTS = 64;
+    static constexpr int MAX_LENGTH = 9;
+
+    bool valid = false;
+    std::uint32_t seed = 0;
+    std::int8_t slots[SLOTS] = {};
+    std::int8_t lengths[sizeof(KEYWORDS) / sizeof(KEYWORDS[0])] = {};
+
+    static constexpr int slotOf(std::uint32_t seed, std::uint32_t first, std::uint32_t last, int length) {
+        return int(((first << 16 | last << 8 | std::uint32_t(length)) * seed) >> 26);
+    }
+
+    template <typename Unit>
+    constexpr int find(const Unit* s, int length) const {
+        if (length < 2 || length > MAX_LENGTH) {
+            return -1;
+        }
+
+        int keyword = slots[slotOf(seed, foldCase(lexemeUnit(s[0])), foldCase(lexemeUnit(s[length - 1])), length)];
+        if (keyword < 0 || lengths[keyword] != length) {
+            return -1;
+        }
+        for (int i = 0; i < length; ++i) {
+            if (foldCase(lexemeUnit(s[i])) != lexemeUnit(KEYWORDS[keyword][i])) {
+                return -1;
+            }
+        }
+        return keyword;
+    }
+};
+
+
+constexpr KeywordHash buildKeywordHash() {
+    constexpr int count = int(sizeof(KEYWORDS) / sizeof(KEYWORDS[0]));
+    KeywordHash hash;
+    for (int k = 0; k < count; ++k) {
+        int length = 0;
+        while (KEYWORDS[k][length]) {
+            length++;
+        }
+        hash.lengths[k] = std::int8_t(length);
+    }
+
+    for (std::uint32_t seed = 0x9e3779b1u; seed < 0x9e3779b1u + 2 * 100000; seed += 2) {
+        std::uint64_t used = 0;
+        bool collision = false;
+        for (int k = 0; k < count && !collision; ++k) {
+            int length = hash.lengths[k];
+            int slot = KeywordHash::slotOf(seed, lexemeUnit(KEYWORDS[k][0]), lexemeUnit(KEYWORDS[k][length - 1]), length);
+            collision = (used >> slot) & 1;
+            used |= std::uint64_t(1) << slot;
+        }
+        if (collision) {
+            continue;
+        }
+
+        for (int slot = 0; slot < KeywordHash::SLOTS; ++slot) {
+            hash.slots[slot] = -1;
+        }
+        for (int k = 0; k < count; ++k) {
+            int length = hash.lengths[k];
+            hash.slots[KeywordHash::slotOf(seed, lexemeUnit(KEYWORDS[k][0]), lexemeUnit(KEYWORDS[k][length - 1]), length)] = std::int8_t(k);
+        }
+        hash.seed = seed;
+        hash.valid = true;
+        return hash;
+    }
+    return hash;
+}
+
+
+struct LexemeTables {
+    static constexpr KeywordHash keywords = buildKeywordHash();
+
+    template <typename Unit>
+    static constexpr bool isKeyword(const Unit* s, int length) {
+        return keywords.find(s, length) >= 0;
+    }
+
+    template <typename Unit>
+    static constexpr TokenType operatorType(const Unit* s, int length) {
+        if (length == 1) {
+            switch (lexemeUnit(s[0])) {
+            case '+': return TokenType::PLUS;
+            case '-': return TokenType::MINUS;
+            case '*': return TokenType::MULTIPLY;
+            case '/': return TokenType::DIVIDE;
+            case '%': return TokenType::MODULO;
+            case '=': return TokenType::ASSIGN;
+            case '<': return TokenType::LESS_THAN;
+            case '>': return TokenType::GREATER_THAN;
+            case '!': return TokenType::LOGICAL_NOT;
+            case '&': return TokenType::BITWISE_AND;
+            case '|': return TokenType::BITWISE_OR;
+            case '^': return TokenType::BITWISE_XOR;
+            case '~': return TokenType::BITWISE_NOT;
+            case ';': return TokenType::SEMICOLON;
+            case ',': return TokenType::COMMA;
+            case '.': return TokenType::DOT;
+            case ':': return TokenType::COLON;
+            case '(': return TokenType::LPAREN;
+            case ')': return TokenType::RPAREN;
+            case '{': return TokenType::LBRACE;
+            case '}': return TokenType::RBRACE;
+            case '[': return TokenType::LBRACKET;
+            case ']': return TokenType::RBRACKET;
+            default: return TokenType::UNKNOWN;
+            }
+        }
+
+        if (length == 2) {
+            std::uint32_t second = lexemeUnit(s[1]);
+            switch (lexemeUnit(s[0])) {
+            case '=': return second == '=' ? TokenType::EQUAL : TokenType::UNKNOWN;
+            case '!': return second == '=' ? TokenType::NOT_EQUAL : TokenType::UNKNOWN;
+            case '<': return second == '=' ? TokenType::LESS_EQUAL : TokenType::UNKNOWN;
+            case '>': return second == '=' ? TokenType::GREATER_EQUAL : TokenType::UNKNOWN;
+            case '&': return second == '&' ? TokenType::LOGICAL_AND : TokenType::UNKNOWN;
+            case '|': return second == '|' ? TokenType::LOGICAL_OR : TokenType::UNKNOWN;
+            default: return TokenType::UNKNOWN;
+            }
+        }
+        return TokenType::UNKNOWN;
+    }
+};
+
+static_assert(LexemeTables::keywords.valid, "keyword perfect hash failed to build");
+static_assert(LexemeTables::isKeyword("protected", 9) && LexemeTables::isKeyword("WHILE", 5),
+              "keyword perfect hash is wrong");
+static_assert(!LexemeTables::isKeyword("iff", 3) && !LexemeTables::isKeyword("cases", 5),
+              "keyword perfect hash is wrong");
+static_assert(LexemeTables::operatorType("&&", 2) == TokenType::LOGICAL_AND &&
+              LexemeTables::operatorType("=>", 2) == TokenType::UNKNOWN, "operator table is wrong");
+
+#endif
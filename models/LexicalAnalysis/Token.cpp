@@ -1,20 +1,131 @@
 #include "Token.h"
+#include "LexemeTables.h"
 #include <QMap>
-#include <QSet>
+#include <algorithm>
+
+TokenSource::TokenSource(const QString& text, const QVector<QString>& ruleIds, const QVector<int>& lineStarts)
+    : text(text), encodedUtf8(false), ruleIds(ruleIds), lineStarts(lineStarts), firstLine(1), firstColumn(1) {
+    indexLines();
+}
+
+TokenSource::TokenSource(const QString& text, const QVector<QString>& ruleIds, int firstLine, int firstColumn)
+    : TokenSource(text, ruleIds) {
+    this->firstLine = firstLine;
+    this->firstColumn = firstColumn;
+}
+
+TokenSource::TokenSource(const char* bytes, int size, const QVector<QString>& ruleIds,
+                         std::shared_ptr<const void> owner, const QVector<int>& lineStarts)
+    : utf8(QByteArray::fromRawData(bytes, size)), owner(std::move(owner)), encodedUtf8(true),
+    ruleIds(ruleIds), lineStarts(lineStarts), firstLine(1), firstColumn(1) {
+    indexLines();
+}
+
+void TokenSource::indexLines() {
+    if (!lineStarts.isEmpty()) {
+        return;
+    }
+
+    lineStarts.append(0);
+    for (int i = 0; i < size(); ++i) {
+        bool newline = encodedUtf8 ? utf8.constData()[i] == '\n' : text.constData()[i] == QLatin1Char('\n');
+        if (newline) {
+            lineStarts.append(i + 1);
+        }
+    }
+}
+
+QAnyStringView TokenSource::view(int offset, int length) const {
+    if (encodedUtf8) {
+        return QUtf8StringView(utf8.constData() + offset, length);
+    }
+    return QStringView(text).mid(offset, length);
+}
+
+QString TokenSource::lexeme(int offset, int length) const {
+    if (encodedUtf8) {
+        return QString::fromUtf8(utf8.constData() + offset, length);
+    }
+    return text.mid(offset, length);
+}
+
+int TokenSource::lineOf(int offset) const {
+    return firstLine - 1 + int(std::upper_bound(lineStarts.begin(), lineStarts.end(), offset) - lineStarts.begin());
+}
+
+int TokenSource::columnOf(int offset) const {
+    int index = int(std::upper_bound(lineStarts.begin(), lineStarts.end(), offset) - lineStarts.begin());
+    int start = lineStarts[index - 1];
+    int column = index == 1 ? firstColumn : 1;
+    if (!encodedUtf8) {
+        return column + offset - start;
+    }
+
+    const char* bytes = utf8.constData();
+    for (int i = start; i < offset; ++i) {
+        if ((uchar(bytes[i]) & 0xc0) != 0x80) {
+            column++;
+        }
+    }
+    return column;
+}
 
 Token::Token()
-    : type(TokenType::UNKNOWN), lexeme(""), automatonId(""), line(0), column(0) {}
+    : type(TokenType::UNKNOWN), ruleId(-1), offset(0), length(0) {}
 
 Token::Token(TokenType type, const QString& lexeme, int line, int column, const QString& automatonId)
-    : type(type), lexeme(lexeme), automatonId(automatonId), line(line), column(column) {}
+    : type(type), ruleId(-1), offset(0), length(lexeme.length()) {
+    if (!lexeme.isEmpty() || !automatonId.isEmpty() || line != 0 || column != 0) {
+        QVector<QString> ruleIds;
+        if (!automatonId.isEmpty()) {
+            ruleIds.append(automatonId);
+            ruleId = 0;
+        }
+        source = QSharedPointer<const TokenSource>(new TokenSource(lexeme, ruleIds, line, column));
+    }
+}
+
+Token::Token(TokenType type, const QSharedPointer<const TokenSource>& source, int offset, int length, int ruleId)
+    : type(type), ruleId(ruleId), offset(offset), length(length), source(source) {}
+
+QString Token::getLexeme() const {
+    return source ? source->lexeme(offset, length) : QString();
+}
+
+QAnyStringView Token::getLexemeView() const {
+    return source ? source->view(offset, length) : QAnyStringView();
+}
+
+QString Token::getAutomatonId() const {
+    return source ? source->getRuleId(ruleId) : QString();
+}
+
+void Token::setLexeme(const QString& lex) {
+    *this = Token(type, lex, getLine(), getColumn(), getAutomatonId());
+}
+
+void Token::setAutomatonId(const QString& id) {
+    *this = Token(type, getLexeme(), getLine(), getColumn(), id);
+}
+
+void Token::setLine(int l) {
+    *this = Token(type, getLexeme(), l, getColumn(), getAutomatonId());
+}
+
+void Token::setColumn(int c) {
+    *this = Token(type, getLexeme(), getLine(), c, getAutomatonId());
+}
 
 QString Token::getTypeString() const {
+    if (type == TokenType::AUTOMATON && !getAutomatonId().isEmpty()) {
+        return getAutomatonId();
+    }
     return tokenTypeToString(type);
 }
 
 QString Token::toString() const {
     return QString("Token(%1, \"%2\", Line: %3, Col: %4)")
-    .arg(getTypeString()).arg(lexeme).arg(line).arg(column);
+    .arg(getTypeString()).arg(getLexeme()).arg(getLine()).arg(getColumn());
 }
 
 bool Token::isValid() const {
@@ -29,6 +140,7 @@ QString Token::tokenTypeToString(TokenType type) {
         {TokenType::FLOAT_LITERAL, "FLOAT"},
         {TokenType::STRING_LITERAL, "STRING"},
         {TokenType::CHAR_LITERAL, "CHAR"},
+        {TokenType::AUTOMATON, "AUTOMATON"},
         {TokenType::PLUS, "PLUS"}, {TokenType::MINUS, "MINUS"},
         {TokenType::MULTIPLY, "MULTIPLY"}, {TokenType::DIVIDE, "DIVIDE"},
         {TokenType::MODULO, "MODULO"}, {TokenType::ASSIGN, "ASSIGN"},
@@ -51,34 +163,21 @@ QString Token::tokenTypeToString(TokenType type) {
 }
 
 bool Token::isKeyword(const QString& str) {
-    static QSet<QString> keywords = {
-        "if", "else", "while", "for", "do", "switch", "case", "default",
-        "break", "continue", "return", "void", "int", "float", "double",
-        "char", "bool", "true", "false", "const", "static", "class",
-        "public", "private", "protected", "struct", "enum", "string"
-    };
-    return keywords.contains(str.toLower());
+    return LexemeTables::isKeyword(str.constData(), int(str.length()));
 }
 
 TokenType Token::getKeywordType(const QString& str) {
     return isKeyword(str) ? TokenType::KEYWORD : TokenType::IDENTIFIER;
 }
 
+TokenType Token::getKeywordType(const QChar* text, int length) {
+    return LexemeTables::isKeyword(text, length) ? TokenType::KEYWORD : TokenType::IDENTIFIER;
+}
+
+TokenType Token::getKeywordType(const char* utf8, int length) {
+    return LexemeTables::isKeyword(utf8, length) ? TokenType::KEYWORD : TokenType::IDENTIFIER;
+}
+
 TokenType Token::getOperatorType(const QString& str) {
-    static QMap<QString, TokenType> operators = {
-        {"+", TokenType::PLUS}, {"-", TokenType::MINUS}, {"*", TokenType::MULTIPLY},
-        {"/", TokenType::DIVIDE}, {"%", TokenType::MODULO}, {"=", TokenType::ASSIGN},
-        {"==", TokenType::EQUAL}, {"!=", TokenType::NOT_EQUAL},
-        {"<", TokenType::LESS_THAN}, {">", TokenType::GREATER_THAN},
-        {"<=", TokenType::LESS_EQUAL}, {">=", TokenType::GREATER_EQUAL},
-        {"&&", TokenType::LOGICAL_AND}, {"||", TokenType::LOGICAL_OR},
-        {"!", TokenType::LOGICAL_NOT}, {"&", TokenType::BITWISE_AND},
-        {"|", TokenType::BITWISE_OR}, {"^", TokenType::BITWISE_XOR},
-        {"~", TokenType::BITWISE_NOT}, {";", TokenType::SEMICOLON},
-        {",", TokenType::COMMA}, {".", TokenType::DOT}, {":", TokenType::COLON},
-        {"(", TokenType::LPAREN}, {")", TokenType::RPAREN},
-        {"{", TokenType::LBRACE}, {"}", TokenType::RBRACE},
-        {"[", TokenType::LBRACKET}, {"]", TokenType::RBRACKET}
-    };
-    return operators.value(str, TokenType::UNKNOWN);
+    return LexemeTables::operatorType(str.constData(), int(str.length()));
 }
@@ -2,7 +2,14 @@
 #define TOKEN_H
 
 #include <QString>
+#include <QStringView>
+#include <QAnyStringView>
+#include <QUtf8StringView>
+#include <QByteArray>
+#include <QVector>
+#include <QSharedPointer>
 #include <QMetaType>
+#include <memory>
 
 enum class TokenType {
 
@@ -16,6 +23,9 @@ enum class TokenType {
     CHAR_LITERAL,
 
 
+    AUTOMATON,
+
+
     PLUS, MINUS, MULTIPLY, DIVIDE, MODULO,
     ASSIGN, EQUAL, NOT_EQUAL,
     LESS_THAN, GREATER_THAN, LESS_EQUAL, GREATER_EQUAL,
@@ -35,29 +45,70 @@ enum class TokenType {
     UNKNOWN, END_OF_FILE
 };
 
+class TokenSource {
+private:
+    QString text;
+    QByteArray utf8;
+    std::shared_ptr<const void> owner;
+    bool encodedUtf8;
+    QVector<QString> ruleIds;
+    QVector<int> lineStarts;
+    int firstLine;
+    int firstColumn;
+
+    void indexLines();
+
+public:
+    explicit TokenSource(const QString& text, const QVector<QString>& ruleIds = QVector<QString>(),
+                         const QVector<int>& lineStarts = QVector<int>());
+    TokenSource(const QString& text, const QVector<QString>& ruleIds, int firstLine, int firstColumn);
+    TokenSource(const char* bytes, int size, const QVector<QString>& ruleIds = QVector<QString>(),
+                std::shared_ptr<const void> owner = std::shared_ptr<const void>(),
+                const QVector<int>& lineStarts = QVector<int>());
+
+    bool isUtf8() const { return encodedUtf8; }
+    const QString& getText() const { return text; }
+    const QByteArray& getUtf8() const { return utf8; }
+    int size() const { return encodedUtf8 ? int(utf8.size()) : int(text.size()); }
+    QAnyStringView view(int offset, int length) const;
+    QString lexeme(int offset, int length) const;
+    QString getRuleId(int rule) const { return (rule >= 0 && rule < ruleIds.size()) ? ruleIds[rule] : QString(); }
+
+    int getLineCount() const { return lineStarts.size(); }
+    int lineOf(int offset) const;
+    int columnOf(int offset) const;
+};
+
+
 class Token {
 private:
     TokenType type;
-    QString lexeme;
-    QString automatonId;
-    int line;
-    int column;
+    int ruleId;
+    int offset;
+    int length;
+    QSharedPointer<const TokenSource> source;
 
 public:
     Token();
     Token(TokenType type, const QString& lexeme, int line = 0, int column = 0, const QString& automatonId = "");
+    Token(TokenType type, const QSharedPointer<const TokenSource>& source, int offset, int length, int ruleId = -1);
 
     TokenType getType() const { return type; }
-    QString getLexeme() const { return lexeme; }
-    QString getAutomatonId() const { return automatonId; }
-    int getLine() const { return line; }
-    int getColumn() const { return column; }
+    QString getLexeme() const;
+    QAnyStringView getLexemeView() const;
+    QString getAutomatonId() const;
+    int getRuleId() const { return ruleId; }
+    int getOffset() const { return offset; }
+    int getLength() const { return length; }
+    int getLine() const { return source ? source->lineOf(offset) : 0; }
+    const QSharedPointer<const TokenSource>& getSource() const { return source; }
+    int getColumn() const { return source ? source->columnOf(offset) : 0; }
 
     void setType(TokenType t) { type = t; }
-    void setLexeme(const QString& lex) { lexeme = lex; }
-    void setAutomatonId(const QString& id) { automatonId = id; }
-    void setLine(int l) { line = l; }
-    void setColumn(int c) { column = c; }
+    void setLexeme(const QString& lex);
+    void setAutomatonId(const QString& id);
+    void setLine(int l);
+    void setColumn(int c);
 
     QString getTypeString() const;
     QString toString() const;
@@ -66,6 +117,8 @@ public:
     static QString tokenTypeToString(TokenType type);
     static bool isKeyword(const QString& str);
     static TokenType getKeywordType(const QString& str);
+    static TokenType getKeywordType(const QChar* text, int length);
+    static TokenType getKeywordType(const char* utf8, int length);
     static TokenType getOperatorType(const QString& str);
 };
 
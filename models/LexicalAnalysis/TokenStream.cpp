@@ -0,0 +1,116 @@
+#include "TokenStream.h"
+
+TokenStream::TokenStream() {}
+
+TokenStream::TokenStream(const QSharedPointer<const TokenSource>& source) : source(source) {}
+
+TokenStream::TokenStream(const QVector<Token>& tokens) {
+    for (const auto& token : tokens) {
+        if (token.getSource()) {
+            source = token.getSource();
+            break;
+        }
+    }
+
+    reserve(tokens.size());
+    for (const auto& token : tokens) {
+        append(token);
+    }
+}
+
+void TokenStream::reserve(int count) {
+    types.reserve(count);
+    offsets.reserve(count);
+    lengths.reserve(count);
+    ruleIds.reserve(count);
+}
+
+void TokenStream::clear() {
+    types.clear();
+    offsets.clear();
+    lengths.clear();
+    ruleIds.clear();
+    detached.clear();
+}
+
+void TokenStream::discard(int count) {
+    types.remove(0, count);
+    offsets.remove(0, count);
+    lengths.remove(0, count);
+    ruleIds.remove(0, count);
+}
+
+void TokenStream::append(TokenType type, int offset, int length, int ruleId) {
+    types.append(quint8(type));
+    offsets.append(offset);
+    lengths.append(length);
+    ruleIds.append(ruleId);
+}
+
+
+void TokenStream::append(const Token& token) {
+    if (token.getSource() == source && source) {
+        append(token.getType(), token.getOffset(), token.getLength(), token.getRuleId());
+        return;
+    }
+
+    append(token.getType(), -1 - detached.size(), token.getLength(), -1);
+    detached.append(token);
+}
+
+void TokenStream::append(const TokenStream& other, int index) {
+    if (other.source == source && other.offsets[index] >= 0) {
+        append(other.typeAt(index), other.offsets[index], other.lengths[index], other.ruleIds[index]);
+    } else {
+        append(other.at(index));
+    }
+}
+
+void TokenStream::append(const TokenStream& other) {
+    if (other.source != source || !other.detached.isEmpty()) {
+        for (int i = 0; i < other.size(); ++i) {
+            append(other, i);
+        }
+        return;
+    }
+
+    types += other.types;
+    offsets += other.offsets;
+    lengths += other.lengths;
+    ruleIds += other.ruleIds;
+}
+
+QAnyStringView TokenStream::lexemeAt(int index) const {
+    int offset = offsets[index];
+    if (offset < 0) {
+        return detached[-1 - offset].getLexemeView();
+    }
+    return source->view(offset, lengths[index]);
+}
+
+int TokenStream::lineAt(int index) const {
+    int offset = offsets[index];
+    return offset < 0 ? detached[-1 - offset].getLine() : source->lineOf(offset);
+}
+
+int TokenStream::columnAt(int index) const {
+    int offset = offsets[index];
+    return offset < 0 ? detached[-1 - offset].getColumn() : source->columnOf(offset);
+}
+
+Token TokenStream::at(int index) const {
+    int offset = offsets[index];
+    if (offset < 0) {
+        return detached[-1 - offset];
+    }
+    return Token(typeAt(index), source, offset, lengths[index], ruleIds[index]);
+}
+
+QVector<Token> TokenStream::toTokens() const {
+    QVector<Token> tokens;
+    tokens.reserve(size());
+    for (int i = 0; i < size(); ++i) {
+        tokens.append(at(i));
+    }
+    return tokens;
+}
@@ -0,0 +1,51 @@
+#ifndef TOKENSTREAM_H
+#define TOKENSTREAM_H
+
+#include "Token.h"
+#include <QSharedPointer>
+#include <QAnyStringView>
+#include <QString>
+#include <QVector>
+
+class TokenStream {
+private:
+    QSharedPointer<const TokenSource> source;
+    QVector<quint8> types;
+    QVector<int> offsets;
+    QVector<int> lengths;
+    QVector<int> ruleIds;
+    QVector<Token> detached;
+
+public:
+    TokenStream();
+    explicit TokenStream(const QSharedPointer<const TokenSource>& source);
+    TokenStream(const QVector<Token>& tokens);
+
+    const QSharedPointer<const TokenSource>& getSource() const { return source; }
+    void reserve(int count);
+    void clear();
+    void discard(int count);
+
+    void append(TokenType type, int offset, int length, int ruleId = -1);
+    void append(const Token& token);
+    void append(const TokenStream& other, int index);
+    void append(const TokenStream& other);
+
+
+    int size() const { return types.size(); }
+    bool isEmpty() const { return types.isEmpty(); }
+
+    TokenType typeAt(int index) const { return TokenType(types[index]); }
+    int offsetAt(int index) const { return offsets[index]; }
+    int lengthAt(int index) const { return lengths[index]; }
+    int ruleIdAt(int index) const { return ruleIds[index]; }
+    QAnyStringView lexemeAt(int index) const;
+    int lineAt(int index) const;
+    int columnAt(int index) const;
+
+    Token at(int index) const;
+    Token operator[](int index) const { return at(index); }
+    QVector<Token> toTokens() const;
+};
+
+#endif
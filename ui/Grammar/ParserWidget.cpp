@@ -5,6 +5,7 @@
 #include <QSplitter>
 #include <QMessageBox>
 #include <QInputDialog>
+#include <QThread>
 
 ParserWidget::ParserWidget(QWidget *parent)
     : QWidget(parent), currentGrammar(nullptr), automatonManager(nullptr) {
@@ -12,6 +13,7 @@ ParserWidget::ParserWidget(QWidget *parent)
     currentGrammar = new Grammar();
     parser = new Parser(currentGrammar);
     lexer = new Lexer();
+    lexer->setThreadCount(QThread::idealThreadCount());
 
     setupUI();
     createConnections();
@@ -335,8 +337,7 @@ void ParserWidget::onParseClicked() {
         return;
     }
 
-    QVector<Token> tokens = lexer->getTokens();
-    parser->setTokens(tokens);
+    parser->setTokens(lexer->getTokenStream());
 
      
     ParseTree tree = parser->parse();
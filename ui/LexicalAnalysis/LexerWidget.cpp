@@ -5,11 +5,13 @@
 #include <QHeaderView>
 #include <QMessageBox>
 #include <QSplitter>
+#include <QThread>
 
 LexerWidget::LexerWidget(QWidget *parent)
     : QWidget(parent), automatonManager(nullptr) {
 
     lexer = new Lexer();
+    lexer->setThreadCount(QThread::idealThreadCount());
     setupUI();
     createConnections();
 }
@@ -175,7 +177,7 @@ void LexerWidget::onTokenizeClicked() {
 
     if (success) {
         statusLabel->setText(QString("✅ Tokenization successful! Generated %1 tokens.")
-                                 .arg(lexer->getTokens().size()));
+                                 .arg(lexer->getTokenStream().size()));
         statusLabel->setStyleSheet("QLabel { padding: 5px; background-color: #d4edda; color: #155724; border-radius: 3px; }");
     } else {
         statusLabel->setText(QString("❌ Tokenization completed with %1 error(s).")
@@ -235,6 +237,9 @@ void LexerWidget::displayTokens(const QVector<Token>& tokens) {
         case TokenType::CHAR_LITERAL:
             bgColor = QColor(150, 50, 100);       
             break;
+        case TokenType::AUTOMATON:
+            bgColor = QColor(100, 60, 150);
+            break;
         case TokenType::PLUS:
         case TokenType::MINUS:
         case TokenType::MULTIPLY:
@@ -2,8 +2,15 @@
 #include "./src/utils/Automaton/NFAtoDFA.h"  
 #include "./src/utils/Automaton/DFAMinimizer.h"  
 #include "./src/utils/Automaton/RegexToNFA.h"  
+#include "./src/utils/Automaton/RegexCache.h"
+#include "./src/utils/Automaton/DFACodeGenerator.h"
+#include "./src/utils/Automaton/CompressedDFA.h"
+#include "./src/utils/Automaton/AutomatonBinary.h"
+#include "./src/utils/Automaton/AutomatonImporter.h"
+#include "./src/utils/Automaton/AutomatonExporter.h"
 #include <QInputDialog>  
 #include <QFileDialog>   
+#include <QFile>
 #include <QDialog>       
 #include <QCheckBox>     
 #include <QtMath>        
@@ -12,6 +19,8 @@
 #include <QHeaderView>   
 #include <QDebug>        
 #include <QShortcut>     
+#include <QThreadPool>
+#include <QPointer>
 #include <QDialog>       
 
  
@@ -26,7 +35,7 @@ MainWindow::MainWindow(QWidget *parent)
     toolsDock(nullptr), automatonListDock(nullptr), propertiesDock(nullptr),
     automatonList(nullptr),
     typeLabel(nullptr), stateCountLabel(nullptr), transitionCountLabel(nullptr),
-    alphabetLabel(nullptr), selectedStateLabel(nullptr), deleteStateBtn(nullptr),
+    alphabetLabel(nullptr), memoryLabel(nullptr), selectedStateLabel(nullptr), deleteStateBtn(nullptr),
     transitionTable(nullptr), convertNFAtoDFABtn(nullptr), minimizeDFABtn(nullptr),
     selectModeBtn(nullptr), addStateModeBtn(nullptr), addTransitionModeBtn(nullptr),
     deleteModeBtn(nullptr), clearCanvasBtn(nullptr), newAutomatonBtn(nullptr),
@@ -304,6 +313,12 @@ void MainWindow::createPropertiesPanel() {
     alphabetLabel->setWordWrap(true);
     infoLayout->addWidget(alphabetLabel);
 
+    memoryLabel = new QLabel("Memory: N/A");
+    memoryLabel->setWordWrap(true);
+    memoryLabel->setTextFormat(Qt::RichText);
+    connect(memoryLabel, &QLabel::linkActivated, this, &MainWindow::onMeasureCompression);
+    infoLayout->addWidget(memoryLabel);
+
     infoGroup->setLayout(infoLayout);
     layout->addWidget(infoGroup);
 
@@ -761,6 +776,7 @@ void MainWindow::onDeleteAutomaton() {
             if (currentAutomaton && currentAutomaton->getId() == id) {
                 currentAutomaton = nullptr;
                 currentSelectedStateId = "";
+                snapshots.clear();
                 if (canvas) {
                     canvas->setAutomaton(nullptr);
                 }
@@ -795,6 +811,9 @@ void MainWindow::onRenameAutomaton() {
 
         if (ok && !newName.isEmpty()) {
             automaton->setName(newName);
+            if (automaton == currentAutomaton) {
+                snapshots.publish(*automaton);
+            }
             updateAutomatonList();
             statusBar()->showMessage(QString("Automaton renamed to: %1").arg(newName));
         }
@@ -1060,8 +1079,9 @@ void MainWindow::onConvertNFAtoDFA() {
     }
 
     try {
+        std::shared_ptr<const AutomatonSnapshot> snapshot = snapshots.current();
         NFAtoDFA converter;
-        Automaton* dfaAutomaton = converter.convert(currentAutomaton);
+        Automaton* dfaAutomaton = snapshot ? converter.convert(&snapshot->getAutomaton()) : nullptr;
 
         if (dfaAutomaton) {
             QString id = generateAutomatonId();
@@ -1172,8 +1192,9 @@ void MainWindow::onMinimizeDFA() {
     }
 
     try {
+        std::shared_ptr<const AutomatonSnapshot> snapshot = snapshots.current();
         DFAMinimizer minimizer;
-        Automaton* minimizedDFA = minimizer.minimize(currentAutomaton);
+        Automaton* minimizedDFA = snapshot ? minimizer.minimize(&snapshot->getAutomaton()) : nullptr;
 
         if (minimizedDFA) {
             QString id = generateAutomatonId();
@@ -1233,6 +1254,25 @@ void MainWindow::onMinimizeDFA() {
 
  
 
+void MainWindow::onMeasureCompression() {
+    if (!currentAutomaton || !memoryLabel) {
+        return;
+    }
+
+    auto kilobytes = [](qint64 bytes) { return QString::number(bytes / 1024.0, 'f', 1); };
+    QString memoryText = QString("Memory: %1 KB as graph")
+                             .arg(kilobytes(RegexCache::estimateBytes(currentAutomaton)));
+    CompressedDFA compressed;
+    if (compressed.compile(currentAutomaton)) {
+        memoryText += QString(", %1 KB compressed (%2 KB dense)")
+                          .arg(kilobytes(compressed.memoryBytes()))
+                          .arg(kilobytes(compressed.denseBytes()));
+    } else {
+        memoryText += ", <span style='color: #999;'>not compressible</span>";
+    }
+    memoryLabel->setText(memoryText);
+}
+
 void MainWindow::onTestAutomaton() {
     if (!currentAutomaton) {
         QMessageBox::warning(this, "No Automaton", "Please create or select an automaton first.");
@@ -1287,15 +1327,28 @@ void MainWindow::onTestAutomaton() {
             return;
         }
 
-        bool accepted = currentAutomaton->accepts(input);
-        QString result;
-        if (accepted) {
-            result = QString("<span style='color: #4caf50; font-weight: bold;'>✅ ACCEPTED</span> - Input: \"%1\"").arg(input);
-        } else {
-            result = QString("<span style='color: #f44336; font-weight: bold;'>❌ REJECTED</span> - Input: \"%1\"").arg(input);
+        std::shared_ptr<const AutomatonSnapshot> snapshot = snapshots.current();
+        if (!snapshot) {
+            return;
         }
-        resultsText->append(result + "<br>");
         inputField->clear();
+
+        QPointer<QTextEdit> output(resultsText);
+        QThreadPool::globalInstance()->start([this, snapshot, input, output]() {
+            bool accepted = snapshot->accepts(input);
+            QMetaObject::invokeMethod(this, [accepted, input, output]() {
+                if (!output) {
+                    return;
+                }
+                QString result;
+                if (accepted) {
+                    result = QString("<span style='color: #4caf50; font-weight: bold;'>✅ ACCEPTED</span> - Input: \"%1\"").arg(input);
+                } else {
+                    result = QString("<span style='color: #f44336; font-weight: bold;'>❌ REJECTED</span> - Input: \"%1\"").arg(input);
+                }
+                output->append(result + "<br>");
+            }, Qt::QueuedConnection);
+        });
     });
 
      
@@ -1359,13 +1412,19 @@ void MainWindow::onTraceAutomaton() {
             return;
         }
 
+        std::shared_ptr<const AutomatonSnapshot> snapshot = snapshots.current();
+        if (!snapshot) {
+            return;
+        }
+        const Automaton& automaton = snapshot->getAutomaton();
+
         traceText->clear();
         traceText->append(QString("<div style='color: #4ec9b0; font-weight: bold;'>═══ EXECUTION TRACE ═══</div>"));
         traceText->append(QString("<div style='color: #9cdcfe;'>Input: \"%1\"</div>").arg(input));
         traceText->append(QString("<div style='color: #9cdcfe;'>Length: %1 symbols</div><br>").arg(input.length()));
 
          
-        QString startState = currentAutomaton->getInitialStateId();
+        QString startState = automaton.getInitialStateId();
         if (startState.isEmpty()) {
             traceText->append("<div style='color: #f44336;'>❌ ERROR: No initial state defined!</div>");
             return;
@@ -1374,7 +1433,7 @@ void MainWindow::onTraceAutomaton() {
          
         QSet<QString> currentStates;
         currentStates.insert(startState);
-        currentStates = currentAutomaton->epsilonClosure(currentStates);
+        currentStates = automaton.epsilonClosure(currentStates);
 
          
         auto formatStates = [](const QSet<QString>& states) {
@@ -1393,7 +1452,7 @@ void MainWindow::onTraceAutomaton() {
 
              
             for (const auto& stateId : currentStates) {
-                for (const auto& trans : currentAutomaton->getTransitions()) {
+                for (const auto& trans : automaton.getTransitions()) {
                     if (trans.getFromStateId() == stateId && trans.hasSymbol(symbol)) {
                         nextStates.insert(trans.getToStateId());
                     }
@@ -1401,7 +1460,7 @@ void MainWindow::onTraceAutomaton() {
             }
 
              
-            nextStates = currentAutomaton->epsilonClosure(nextStates);
+            nextStates = automaton.epsilonClosure(nextStates);
 
             if (nextStates.isEmpty()) {
                 traceText->append(QString("<div style='color: #f44336;'>Step %1: Read '%2' from states <b>%3</b> → <b>DEAD END</b> ❌</div>")
@@ -1423,7 +1482,7 @@ void MainWindow::onTraceAutomaton() {
             QStringList finalStatesReached;
             
             for (const auto& stateId : currentStates) {
-                const State* state = currentAutomaton->getState(stateId);
+                const State* state = automaton.getState(stateId);
                 if (state && state->getIsFinal()) {
                     isAccepted = true;
                     finalStatesReached.append(stateId);
@@ -1534,6 +1593,7 @@ void MainWindow::onFromRegex() {
         "<tr><td class='op'>a*</td><td class='desc'>Kleene Star (zero or more)</td></tr>"
         "<tr><td class='op'>a+</td><td class='desc'>Plus (one or more)</td></tr>"
         "<tr><td class='op'>a?</td><td class='desc'>Optional (zero or one)</td></tr>"
+        "<tr><td class='op'>a{m,n}</td><td class='desc'>Between m and n times ({m} exactly, {m,} at least)</td></tr>"
         "<tr><td class='op'>(...)</td><td class='desc'>Grouping</td></tr>"
         "<tr><td class='op'>E or ε</td><td class='desc'>Epsilon (empty string)</td></tr>"
         "</table>"
@@ -1592,6 +1652,18 @@ void MainWindow::onFromRegex() {
     dialogLayout->addLayout(btnLayout);
 
      
+    auto cacheSummary = []() {
+        RegexCacheStatistics stats = RegexCache::instance().getStatistics();
+        return QString("Regex cache: %1 hits, %2 misses, %3 entries (%4 / %5 KB)")
+            .arg(stats.hits).arg(stats.misses).arg(stats.entries)
+            .arg(stats.bytes / 1024).arg(stats.budget / 1024);
+    };
+
+    QLabel* cacheLabel = new QLabel(cacheSummary());
+    cacheLabel->setStyleSheet("color: #888; font-size: 8pt; padding: 2px;");
+    dialogLayout->addWidget(cacheLabel);
+
+     
     connect(regexInput, &QLineEdit::textChanged, [&, regexInput, validationLabel, generateBtn](const QString& text) {
         if (text.isEmpty()) {
             validationLabel->setText("");
@@ -1633,16 +1705,17 @@ void MainWindow::onFromRegex() {
         }
 
          
-        RegexToNFA converter;
-        Automaton* nfa = converter.convert(regex);
+        QSharedPointer<const Automaton> cached = RegexCache::instance().get(regex);
 
-        if (!nfa) {
+        if (cached.isNull()) {
             showStyledMessageBox("Error", 
                                  "Failed to convert regular expression to NFA.", 
                                  QMessageBox::Critical);
             return;
         }
 
+        Automaton* nfa = new Automaton(*cached);
+
          
         QString id = nfa->getId();
         automatons[id] = nfa;
@@ -1659,11 +1732,14 @@ void MainWindow::onFromRegex() {
             }
         }
 
-        statusBar()->showMessage(QString("✓ Generated NFA from regex: /%1/").arg(regex), 5000);
+        statusBar()->showMessage(QString("✓ Generated NFA from regex: /%1/ - %2").arg(regex).arg(cacheSummary()), 5000);
     }
 }
 
 void MainWindow::onAutomatonModified() {
+    if (currentAutomaton) {
+        snapshots.publish(*currentAutomaton);
+    }
     updateProperties();
 }
 
@@ -1677,8 +1753,45 @@ void MainWindow::onNew() {
 }
 
 void MainWindow::onOpen() {
-    showStyledMessageBox("Info", "Load functionality will be implemented in next phase.",
-                         QMessageBox::Information);
+    QString fileName = QFileDialog::getOpenFileName(
+        this, "Open Automaton", QString(),
+        "Automata (*.autd *.jff *.dot *.gv *.json);;"
+        "Compiled automaton (*.autd);;JFLAP (*.jff);;Graphviz DOT (*.dot *.gv);;JSON (*.json)");
+
+    if (fileName.isEmpty()) {
+        return;
+    }
+
+    QString error;
+    QString id = generateAutomatonId();
+    Automaton* loaded = nullptr;
+    if (AutomatonImporter::formatForFile(fileName) != AutomatonImporter::Format::Unknown) {
+        AutomatonImporter importer;
+        loaded = importer.importFile(fileName, id, &error);
+    } else {
+        loaded = AutomatonBinary::read(fileName, id, &error);
+    }
+    if (!loaded) {
+        showStyledMessageBox("Error", error, QMessageBox::Critical);
+        return;
+    }
+
+    automatons[id] = loaded;
+    updateAutomatonList();
+
+    for (int i = 0; i < automatonList->count(); ++i) {
+        QListWidgetItem* item = automatonList->item(i);
+        if (item && item->data(Qt::UserRole).toString() == id) {
+            automatonList->setCurrentItem(item);
+            setCurrentAutomaton(loaded);
+            break;
+        }
+    }
+
+    statusBar()->showMessage(QString("✓ Loaded %1 (%2 states) from %3")
+                                 .arg(loaded->getName())
+                                 .arg(loaded->getStateCount())
+                                 .arg(fileName), 5000);
 }
 
 void MainWindow::onSave() {
@@ -1687,8 +1800,69 @@ void MainWindow::onSave() {
         return;
     }
 
-    showStyledMessageBox("Info", "Save functionality will be implemented in next phase.",
-                         QMessageBox::Information);
+    QString binaryFilter = "Compiled automaton (*.autd)";
+    QString directFilter = "C++ matcher, direct-coded (*.h *.hpp)";
+    QString tableFilter = "C++ matcher, constexpr table (*.h *.hpp)";
+    QString jflapFilter = "JFLAP (*.jff)";
+    QString dotFilter = "Graphviz DOT (*.dot *.gv)";
+    QString jsonFilter = "JSON (*.json)";
+    QString selectedFilter;
+    QString fileName = QFileDialog::getSaveFileName(
+        this, "Save Automaton",
+        DFACodeGenerator::sanitizeIdentifier(currentAutomaton->getName()) + ".autd",
+        binaryFilter + ";;" + directFilter + ";;" + tableFilter + ";;" +
+        jflapFilter + ";;" + dotFilter + ";;" + jsonFilter, &selectedFilter);
+
+    if (fileName.isEmpty()) {
+        return;
+    }
+
+    if (selectedFilter == jflapFilter || selectedFilter == dotFilter || selectedFilter == jsonFilter) {
+        if (AutomatonImporter::formatForFile(fileName) == AutomatonImporter::Format::Unknown) {
+            fileName += (selectedFilter == jflapFilter) ? ".jff" : (selectedFilter == dotFilter) ? ".dot" : ".json";
+        }
+
+        QString error;
+        AutomatonExporter exporter;
+        if (!exporter.exportFile(currentAutomaton, fileName, &error)) {
+            showStyledMessageBox("Error", error, QMessageBox::Critical);
+            return;
+        }
+        statusBar()->showMessage(QString("✓ Exported automaton to %1").arg(fileName), 5000);
+        return;
+    }
+
+    if (selectedFilter == binaryFilter) {
+        QString error;
+        if (!AutomatonBinary::write(currentAutomaton, fileName, &error)) {
+            showStyledMessageBox("Error", error, QMessageBox::Critical);
+            return;
+        }
+        statusBar()->showMessage(QString("✓ Saved compiled automaton to %1").arg(fileName), 5000);
+        return;
+    }
+
+    DFACodeGenerator generator;
+    DFACodeGenerator::Style style = (selectedFilter == tableFilter)
+        ? DFACodeGenerator::Style::TableDriven
+        : DFACodeGenerator::Style::DirectCoded;
+
+    QString error;
+    QString code = generator.generate(currentAutomaton, style, QString(), &error);
+    if (code.isEmpty()) {
+        showStyledMessageBox("Error", error, QMessageBox::Critical);
+        return;
+    }
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        showStyledMessageBox("Error", QString("Could not write to %1").arg(fileName), QMessageBox::Critical);
+        return;
+    }
+    file.write(code.toUtf8());
+    file.close();
+
+    statusBar()->showMessage(QString("✓ Saved matcher to %1").arg(fileName), 5000);
 }
 
 void MainWindow::onExit() {
@@ -1712,7 +1886,7 @@ void MainWindow::onExit() {
 void MainWindow::updateProperties() {
      
     if (!typeLabel || !stateCountLabel || !transitionCountLabel ||
-        !alphabetLabel || !transitionTable || !convertNFAtoDFABtn ||
+        !alphabetLabel || !memoryLabel || !transitionTable || !convertNFAtoDFABtn ||
         !minimizeDFABtn || !selectedStateLabel || !deleteStateBtn) {
         return;
     }
@@ -1722,6 +1896,7 @@ void MainWindow::updateProperties() {
         stateCountLabel->setText("States: 0");
         transitionCountLabel->setText("Transitions: 0");
         alphabetLabel->setText("Alphabet: {}");
+        memoryLabel->setText("Memory: N/A");
         transitionTable->setRowCount(0);
         convertNFAtoDFABtn->setEnabled(false);
         minimizeDFABtn->setEnabled(false);
@@ -1798,6 +1973,13 @@ void MainWindow::updateProperties() {
     }
     alphabetLabel->setText(alphText);
 
+    QString memoryText = QString("Memory: %1 KB as graph")
+                             .arg(QString::number(RegexCache::estimateBytes(currentAutomaton) / 1024.0, 'f', 1));
+    if (currentAutomaton->isDFA() && isActuallyDFA) {
+        memoryText += ", <a href=\"compress\">measure compressed</a>";
+    }
+    memoryLabel->setText(memoryText);
+
      
     if (!currentSelectedStateId.isEmpty()) {
         const State* selectedState = currentAutomaton->getState(currentSelectedStateId);
@@ -1897,6 +2079,11 @@ QString MainWindow::generateAutomatonId() {
 void MainWindow::setCurrentAutomaton(Automaton* automaton) {
     currentAutomaton = automaton;
     currentSelectedStateId = "";
+    if (automaton) {
+        snapshots.publish(*automaton);
+    } else {
+        snapshots.clear();
+    }
     if (canvas) {
         canvas->setAutomaton(automaton);
     }
@@ -2016,14 +2203,17 @@ void MainWindow::onPlaySimulation() {
                                              "", &ok);
         if (!ok) return;
 
+        simulationSnapshot = snapshots.current();
+        if (!simulationSnapshot) return;
+
         simulationInput = text;
         simulationStepIndex = 0;
         currentSimulationStates.clear();
-        currentSimulationStates.insert(currentAutomaton->getInitialStateId());
+        currentSimulationStates.insert(simulationSnapshot->getAutomaton().getInitialStateId());
         
          
-        if (currentAutomaton->getType() == AutomatonType::NFA) {
-            currentSimulationStates = currentAutomaton->epsilonClosure(currentSimulationStates);
+        if (simulationSnapshot->getType() == AutomatonType::NFA) {
+            currentSimulationStates = simulationSnapshot->epsilonClosure(currentSimulationStates);
         }
 
         isSimulating = true;
@@ -2063,14 +2253,17 @@ void MainWindow::onStepSimulation() {
                                              "", &ok);
         if (!ok) return;
 
+        simulationSnapshot = snapshots.current();
+        if (!simulationSnapshot) return;
+
         simulationInput = text;
         simulationStepIndex = 0;
         currentSimulationStates.clear();
-        currentSimulationStates.insert(currentAutomaton->getInitialStateId());
+        currentSimulationStates.insert(simulationSnapshot->getAutomaton().getInitialStateId());
 
          
-        if (currentAutomaton->getType() == AutomatonType::NFA) {
-            currentSimulationStates = currentAutomaton->epsilonClosure(currentSimulationStates);
+        if (simulationSnapshot->getType() == AutomatonType::NFA) {
+            currentSimulationStates = simulationSnapshot->epsilonClosure(currentSimulationStates);
         }
 
         isSimulating = true;
@@ -2096,6 +2289,7 @@ void MainWindow::onStepSimulation() {
 void MainWindow::onStopSimulation() {
     isSimulating = false;
     simulationTimer->stop();
+    simulationSnapshot.reset();
     
     playAction->setEnabled(true);
     stepAction->setEnabled(true);
@@ -2126,7 +2320,9 @@ void MainWindow::onSpeedChanged(int value) {
 }
 
 void MainWindow::advanceSimulation() {
-    if (!currentAutomaton || !isSimulating) return;
+    if (!simulationSnapshot || !isSimulating) return;
+    std::shared_ptr<const AutomatonSnapshot> snapshot = simulationSnapshot;
+    const Automaton& automaton = snapshot->getAutomaton();
 
     if (simulationStepIndex >= simulationInput.length()) {
          
@@ -2135,7 +2331,7 @@ void MainWindow::advanceSimulation() {
          
         bool accepted = false;
         for (const auto& stateId : currentSimulationStates) {
-            State* state = currentAutomaton->getState(stateId);
+            const State* state = automaton.getState(stateId);
             if (state && state->getIsFinal()) {
                 accepted = true;
                 break;
@@ -2164,7 +2360,7 @@ void MainWindow::advanceSimulation() {
 
     for (const auto& currentStateId : currentSimulationStates) {
          
-        for (const auto& trans : currentAutomaton->getTransitions()) {
+        for (const auto& trans : automaton.getTransitions()) {
             if (trans.getFromStateId() == currentStateId && trans.hasSymbol(symbol)) {
                 nextStates.insert(trans.getToStateId());
                 activeTransitions.insert(trans.getFromStateId() + "|" + trans.getToStateId());
@@ -2173,8 +2369,8 @@ void MainWindow::advanceSimulation() {
     }
 
      
-    if (currentAutomaton->getType() == AutomatonType::NFA) {
-        nextStates = currentAutomaton->epsilonClosure(nextStates);
+    if (automaton.getType() == AutomatonType::NFA) {
+        nextStates = automaton.epsilonClosure(nextStates);
     }
 
      
@@ -2193,7 +2389,7 @@ void MainWindow::advanceSimulation() {
                                  .arg(currentSimulationStates.size()));
                                  
      
-    if (currentSimulationStates.isEmpty() && currentAutomaton->getType() == AutomatonType::DFA) {
+    if (currentSimulationStates.isEmpty() && automaton.getType() == AutomatonType::DFA) {
         simulationTimer->stop();
         showStyledMessageBox("Result", "String Rejected (Dead State) ✗", QMessageBox::Warning);
         onStopSimulation();
@@ -25,6 +25,7 @@
  
 #include "./src/ui/Automaton/AutomatonCanvas.h"           
 #include "./src/models/Automaton/Automaton.h"             
+#include "./src/models/Automaton/AutomatonSnapshot.h"
 #include "./src/ui/LexicalAnalysis/LexerWidget.h"         
 #include "./src/utils/LexicalAnalysis/AutomatonManager.h"  
 #include "./src/ui/Grammar/ParserWidget.h"                 
@@ -50,6 +51,7 @@ private:
      
     QMap<QString, Automaton*> automatons;  
     Automaton* currentAutomaton;            
+    AutomatonSnapshotPublisher snapshots;
     int automatonCounter;                   
     QString currentSelectedStateId;         
 
@@ -77,6 +79,7 @@ private:
     QLabel* stateCountLabel;            
     QLabel* transitionCountLabel;       
     QLabel* alphabetLabel;              
+    QLabel* memoryLabel;
     QLabel* selectedStateLabel;         
     QPushButton* deleteStateBtn;        
     
@@ -120,6 +123,7 @@ private:
     QString simulationInput;
     int simulationStepIndex;
     QSet<QString> currentSimulationStates;
+    std::shared_ptr<const AutomatonSnapshot> simulationSnapshot;
     bool simulationAccepted;
     bool simulationRejected;
 
@@ -147,6 +151,7 @@ private slots:
      
     void onConvertNFAtoDFA();         
     void onMinimizeDFA();             
+    void onMeasureCompression();
 
      
      
@@ -9,6 +9,7 @@
 #include <QTextDocument>
 #include <QClipboard>
 #include <QApplication>
+#include <QThread>
 #include "../src/ui/SyntaxHighlighter.h"
 #include <QTextDocument>
 
@@ -18,6 +19,7 @@ SemanticAnalyzerWidget::SemanticAnalyzerWidget(QWidget *parent)
     semanticAnalyzer = new SemanticAnalyzer();
     codeGenerator = new CodeGenerator();
     lexer = new Lexer();
+    lexer->setThreadCount(QThread::idealThreadCount());
     syntaxHighlighter = nullptr;
 
     setupUI();
@@ -247,7 +249,7 @@ void SemanticAnalyzerWidget::onAnalyzeClicked() {
     }
 
      
-    semanticAnalyzer->setTokens(lexer->getTokens());
+    semanticAnalyzer->setTokens(lexer->getTokenStream());
     bool success = semanticAnalyzer->analyzeProgram();
 
      
@@ -271,7 +273,7 @@ void SemanticAnalyzerWidget::onAnalyzeClicked() {
 void SemanticAnalyzerWidget::onGenerateCodeClicked() {
     TargetLanguage targetLang = targetLanguageCombo->currentData().value<TargetLanguage>();
 
-    codeGenerator->setTokens(lexer->getTokens());
+    codeGenerator->setTokens(lexer->getTokenStream());
     codeGenerator->setSymbolTable(semanticAnalyzer->getSymbolTable());
     codeGenerator->setTargetLanguage(targetLang);
     codeGenerator->setSourceCode(sourceCodeEdit->toPlainText());  
@@ -0,0 +1,243 @@
+#include "AutomatonBinary.h"
+#include "CompiledDFA.h"
+#include "NFAtoDFA.h"
+#include <QFile>
+#include <QMap>
+#include <QSet>
+#include <cstring>
+#include <limits>
+
+QByteArray AutomatonBinary::serialize(const Automaton* automaton, bool includeLayout,
+                                      bool includeLabels, QString* error) {
+    typedef AutomatonBinaryLayout L;
+
+    if (!automaton || !automaton->isValid()) {
+        if (error) *error = "Automaton is not valid (it needs states and an initial state).";
+        return QByteArray();
+    }
+
+    Automaton* converted = nullptr;
+    const Automaton* dfa = automaton;
+    if (!automaton->isDFA()) {
+        NFAtoDFA converter;
+        converted = converter.convert(automaton);
+        dfa = converted;
+    }
+
+    CompiledDFA compiled;
+    if (!dfa || !compiled.compile(dfa)) {
+        if (error) *error = "Automaton could not be compiled to a DFA.";
+        delete converted;
+        return QByteArray();
+    }
+
+    int states = compiled.getStateCount();
+    int classes = compiled.getClassCount();
+
+    QMap<ushort, int> wide;
+    for (int c = 1; c < classes; ++c) {
+        for (QChar member : compiled.getClassMembers(c)) {
+            if (member.unicode() >= 256) {
+                wide.insert(member.unicode(), c);
+            }
+        }
+    }
+
+    QVector<QString> strings;
+    if (includeLabels) {
+        strings.append(automaton->getName());
+        for (int s = 0; s < states; ++s) {
+            const State* state = dfa->getState(compiled.getStateId(s));
+            strings.append(compiled.getStateId(s));
+            strings.append(state ? state->getLabel() : QString());
+        }
+    }
+    quint64 poolUnits = 0;
+    for (const auto& text : strings) {
+        poolUnits += text.length();
+    }
+
+
+    quint64 classMapOffset = L::HEADER_SIZE;
+    quint64 wideMapOffset = align(classMapOffset + 256 * 2);
+    quint64 tableOffset = align(wideMapOffset + wide.size() * 4);
+    quint64 acceptOffset = align(tableOffset + quint64(states) * classes * 4);
+    quint64 end = align(acceptOffset + states);
+    quint64 layoutOffset = 0;
+    quint64 labelsOffset = 0;
+    if (includeLayout) {
+        layoutOffset = end;
+        end = align(layoutOffset + quint64(states) * 16);
+    }
+    if (includeLabels) {
+        labelsOffset = end;
+        end = align(labelsOffset + 8 + strings.size() * 8 + poolUnits * 2);
+    }
+
+    if (end > quint64(std::numeric_limits<int>::max())) {
+        if (error) *error = "Automaton is too large for the binary format.";
+        delete converted;
+        return QByteArray();
+    }
+
+
+    QByteArray out(int(end), '\0');
+    uchar* bytes = reinterpret_cast<uchar*>(out.data());
+    auto put16 = [bytes](quint64 offset, quint16 value) { qToLittleEndian<quint16>(value, bytes + offset); };
+    auto put32 = [bytes](quint64 offset, quint32 value) { qToLittleEndian<quint32>(value, bytes + offset); };
+
+    quint16 flags = (includeLayout ? L::HAS_LAYOUT : 0) | (includeLabels ? L::HAS_LABELS : 0);
+    put32(L::Magic, L::MAGIC);
+    put16(L::Version, L::VERSION);
+    put16(L::Flags, flags);
+    put32(L::HeaderSize, L::HEADER_SIZE);
+    put32(L::StateCount, states);
+    put32(L::ClassCount, classes);
+    put32(L::InitialState, compiled.getInitialState());
+    put32(L::WideCount, wide.size());
+    put32(L::ClassMapOffset, classMapOffset);
+    put32(L::WideMapOffset, wideMapOffset);
+    put32(L::TableOffset, tableOffset);
+    put32(L::AcceptOffset, acceptOffset);
+    put32(L::LayoutOffset, layoutOffset);
+    put32(L::LabelsOffset, labelsOffset);
+    put32(L::FileSize, end);
+
+    for (int u = 0; u < 256; ++u) {
+        put16(classMapOffset + 2 * u, compiled.classOf(QChar(ushort(u))));
+    }
+
+    quint64 slot = wideMapOffset;
+    for (auto it = wide.constBegin(); it != wide.constEnd(); ++it) {
+        put16(slot, it.key());
+        put16(slot + 2, it.value());
+        slot += 4;
+    }
+
+    for (int s = 0; s < states; ++s) {
+        for (int c = 0; c < classes; ++c) {
+            qint32 target = (c == 0) ? CompiledDFA::DEAD_STATE : compiled.nextByClass(s, c);
+            qToLittleEndian<qint32>(target, bytes + tableOffset + 4 * (quint64(s) * classes + c));
+        }
+        bytes[acceptOffset + s] = compiled.isAccepting(s) ? 1 : 0;
+    }
+
+    if (includeLayout) {
+        for (int s = 0; s < states; ++s) {
+            const State* state = dfa->getState(compiled.getStateId(s));
+            QPointF position = state ? state->getPosition() : QPointF();
+            double x = position.x();
+            double y = position.y();
+            quint64 bitsX, bitsY;
+            std::memcpy(&bitsX, &x, sizeof(double));
+            std::memcpy(&bitsY, &y, sizeof(double));
+            qToLittleEndian<quint64>(bitsX, bytes + layoutOffset + 16 * s);
+            qToLittleEndian<quint64>(bitsY, bytes + layoutOffset + 16 * s + 8);
+        }
+    }
+
+    if (includeLabels) {
+        put32(labelsOffset, strings.size());
+        put32(labelsOffset + 4, poolUnits);
+        quint64 poolOffset = labelsOffset + 8 + strings.size() * 8;
+        quint32 start = 0;
+        for (int i = 0; i < strings.size(); ++i) {
+            const QString& text = strings[i];
+            put32(labelsOffset + 8 + 8 * i, start);
+            put32(labelsOffset + 12 + 8 * i, text.length());
+            for (int k = 0; k < text.length(); ++k) {
+                put16(poolOffset + 2 * (start + k), text[k].unicode());
+            }
+            start += text.length();
+        }
+    }
+
+    delete converted;
+    return out;
+}
+
+bool AutomatonBinary::write(const Automaton* automaton, const QString& fileName, QString* error) {
+    QByteArray bytes = serialize(automaton, true, true, error);
+    if (bytes.isEmpty()) {
+        return false;
+    }
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        if (error) *error = QString("Could not write to %1").arg(fileName);
+        return false;
+    }
+    bool written = file.write(bytes) == bytes.size();
+    file.close();
+
+    if (!written && error) {
+        *error = QString("Could not write to %1").arg(fileName);
+    }
+    return written;
+}
+
+Automaton* AutomatonBinary::toAutomaton(const MappedDFA& dfa, const QString& id, QString* error) {
+    if (!dfa.isValid()) {
+        if (error) *error = "No compiled automaton is loaded.";
+        return nullptr;
+    }
+
+    int states = dfa.getStateCount();
+    int classes = dfa.getClassCount();
+
+    QVector<QSet<QString>> members(classes);
+    for (int c = 1; c < classes; ++c) {
+        for (QChar member : dfa.getClassMembers(c)) {
+            members[c].insert(QString(member));
+        }
+    }
+
+    QVector<QString> ids(states);
+    QVector<State> newStates;
+    newStates.reserve(states);
+    for (int s = 0; s < states; ++s) {
+        ids[s] = dfa.hasLabels() ? dfa.getStateId(s) : QString("q%1").arg(s);
+        QString label = dfa.hasLabels() ? dfa.getStateLabel(s) : ids[s];
+        QPointF position = dfa.hasLayout()
+            ? dfa.getStatePosition(s)
+            : QPointF(100 + (s % 8) * 120, 100 + (s / 8) * 120);
+
+        State state(ids[s], label, position);
+        state.setIsInitial(s == dfa.getInitialState());
+        state.setIsFinal(dfa.isAccepting(s));
+        newStates.append(state);
+    }
+
+    QVector<Transition> newTransitions;
+    for (int s = 0; s < states; ++s) {
+        QMap<int, QSet<QString>> byTarget;
+        for (int c = 1; c < classes; ++c) {
+            int target = dfa.nextByClass(s, c);
+            if (target != MappedDFA::DEAD_STATE) {
+                byTarget[target].unite(members[c]);
+            }
+        }
+        for (auto it = byTarget.constBegin(); it != byTarget.constEnd(); ++it) {
+            if (!it.value().isEmpty()) {
+                newTransitions.append(Transition(ids[s], ids[it.key()], it.value()));
+            }
+        }
+    }
+
+    QString name = dfa.hasLabels() ? dfa.getName() : QString("Loaded automaton");
+    Automaton* automaton = new Automaton(id, name, AutomatonType::DFA);
+    if (!automaton->loadBulk(newStates, newTransitions)) {
+        if (error) *error = "File contents do not form a valid automaton.";
+        delete automaton;
+        return nullptr;
+    }
+    return automaton;
+}
+
+Automaton* AutomatonBinary::read(const QString& fileName, const QString& id, QString* error) {
+    MappedAutomatonFile file;
+    if (!file.open(fileName, error)) {
+        return nullptr;
+    }
+    return toAutomaton(file.getDFA(), id, error);
+}
@@ -0,0 +1,22 @@
+#ifndef AUTOMATONBINARY_H
+#define AUTOMATONBINARY_H
+
+#include "./src/models/Automaton/Automaton.h"
+#include "MappedDFA.h"
+#include <QByteArray>
+#include <QString>
+
+class AutomatonBinary {
+public:
+    static QByteArray serialize(const Automaton* automaton, bool includeLayout = true,
+                                bool includeLabels = true, QString* error = nullptr);
+    static bool write(const Automaton* automaton, const QString& fileName, QString* error = nullptr);
+
+    static Automaton* toAutomaton(const MappedDFA& dfa, const QString& id, QString* error = nullptr);
+    static Automaton* read(const QString& fileName, const QString& id, QString* error = nullptr);
+
+private:
+    static quint32 align(quint32 offset) { return (offset + 7) & ~quint32(7); }
+};
+
+#endif
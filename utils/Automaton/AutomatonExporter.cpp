@@ -0,0 +1,261 @@
+#include "AutomatonExporter.h"
+#include <QFile>
+#include <QXmlStreamWriter>
+#include <QHash>
+#include <algorithm>
+
+AutomatonExporter::AutomatonExporter() : device(nullptr), failed(false) {}
+
+bool AutomatonExporter::exportFile(const Automaton* automaton, const QString& fileName, QString* error) {
+    Format format = AutomatonImporter::formatForFile(fileName);
+    if (format == Format::Unknown) {
+        if (error) *error = "Unknown file format (expected .jff, .dot, .gv or .json).";
+        return false;
+    }
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        if (error) *error = QString("Could not write to %1").arg(fileName);
+        return false;
+    }
+
+    bool written = exportTo(automaton, &file, format, error);
+    file.close();
+    return written;
+}
+
+bool AutomatonExporter::exportTo(const Automaton* automaton, QIODevice* target, Format format, QString* error) {
+    if (!automaton || !target) {
+        if (error) *error = "No automaton to export.";
+        return false;
+    }
+
+    device = target;
+    buffer.clear();
+    buffer.reserve(CHUNK_SIZE);
+    failed = false;
+
+    switch (format) {
+    case Format::JFLAP: writeJFLAP(automaton); break;
+    case Format::DOT: writeDOT(automaton); break;
+    case Format::JSON: writeJSON(automaton); break;
+    case Format::Unknown: failed = true; break;
+    }
+
+    bool ok = flush() && !failed;
+    device = nullptr;
+    if (!ok && error) {
+        *error = format == Format::Unknown ? QString("Unknown export format.") : QString("Could not write the exported automaton.");
+    }
+    return ok;
+}
+
+void AutomatonExporter::put(const QString& text) {
+    buffer += text.toUtf8();
+    if (buffer.size() >= CHUNK_SIZE) {
+        flush();
+    }
+}
+
+void AutomatonExporter::put(const char* text) {
+    buffer += text;
+    if (buffer.size() >= CHUNK_SIZE) {
+        flush();
+    }
+}
+
+bool AutomatonExporter::flush() {
+    if (!buffer.isEmpty()) {
+        if (device->write(buffer) != buffer.size()) {
+            failed = true;
+        }
+        buffer.clear();
+    }
+    return !failed;
+}
+
+bool AutomatonExporter::isEpsilon(const QString& symbol) {
+    return symbol == "E" || symbol == "ε" || symbol == "epsilon" || symbol.isEmpty();
+}
+
+QStringList AutomatonExporter::sortedSymbols(const Transition& transition) {
+    QStringList symbols = transition.getSymbols().values();
+    std::sort(symbols.begin(), symbols.end());
+    return symbols;
+}
+
+
+void AutomatonExporter::writeJFLAP(const Automaton* automaton) {
+    const QVector<State>& states = automaton->getStates();
+    QHash<QString, int> numbers;
+    numbers.reserve(states.size());
+    for (int i = 0; i < states.size(); ++i) {
+        numbers.insert(states[i].getId(), i);
+    }
+
+    QXmlStreamWriter xml(device);
+    xml.setAutoFormatting(true);
+    xml.writeStartDocument();
+    xml.writeStartElement("structure");
+    xml.writeTextElement("type", "fa");
+    xml.writeStartElement("automaton");
+
+    for (int i = 0; i < states.size(); ++i) {
+        const State& state = states[i];
+        xml.writeStartElement("state");
+        xml.writeAttribute("id", QString::number(i));
+        xml.writeAttribute("name", state.getId());
+        xml.writeTextElement("x", QString::number(state.getPosition().x()));
+        xml.writeTextElement("y", QString::number(state.getPosition().y()));
+        if (!state.getLabel().isEmpty() && state.getLabel() != state.getId()) {
+            xml.writeTextElement("label", state.getLabel());
+        }
+        if (state.getIsInitial()) {
+            xml.writeEmptyElement("initial");
+        }
+        if (state.getIsFinal()) {
+            xml.writeEmptyElement("final");
+        }
+        xml.writeEndElement();
+    }
+
+    for (const auto& t : automaton->getTransitions()) {
+        for (const QString& symbol : sortedSymbols(t)) {
+            xml.writeStartElement("transition");
+            xml.writeTextElement("from", QString::number(numbers.value(t.getFromStateId())));
+            xml.writeTextElement("to", QString::number(numbers.value(t.getToStateId())));
+            if (isEpsilon(symbol)) {
+                xml.writeEmptyElement("read");
+            } else {
+                xml.writeTextElement("read", symbol);
+            }
+            xml.writeEndElement();
+        }
+    }
+
+    xml.writeEndElement();
+    xml.writeEndElement();
+    xml.writeEndDocument();
+    failed = failed || xml.hasError();
+}
+
+
+QString AutomatonExporter::quoteDOT(const QString& text) {
+    QString quoted = "\"";
+    for (QChar c : text) {
+        if (c == '"' || c == '\\') {
+            quoted += '\\';
+        }
+        quoted += c;
+    }
+    quoted += '"';
+    return quoted;
+}
+
+void AutomatonExporter::writeDOT(const Automaton* automaton) {
+    put("digraph " + quoteDOT(automaton->getName()) + " {\n");
+    put("    rankdir=LR;\n");
+    put("    node [shape=circle];\n");
+    put("    __start [shape=point, label=\"\"];\n");
+
+    for (const auto& state : automaton->getStates()) {
+        QString line = "    " + quoteDOT(state.getId()) + " [";
+        if (!state.getLabel().isEmpty() && state.getLabel() != state.getId()) {
+            line += "label=" + quoteDOT(state.getLabel()) + ", ";
+        }
+        if (state.getIsFinal()) {
+            line += "shape=doublecircle, ";
+        }
+        line += "pos=\"" + QString::number(state.getPosition().x()) + "," +
+                QString::number(-state.getPosition().y()) + "!\"];\n";
+        put(line);
+    }
+
+    if (!automaton->getInitialStateId().isEmpty()) {
+        put("    __start -> " + quoteDOT(automaton->getInitialStateId()) + ";\n");
+    }
+
+    for (const auto& t : automaton->getTransitions()) {
+        QStringList symbols = sortedSymbols(t);
+        bool separate = false;
+        for (QString& symbol : symbols) {
+            if (isEpsilon(symbol)) {
+                symbol = "ε";
+            }
+            separate = separate || symbol.contains(',');
+        }
+
+        QString edge = "    " + quoteDOT(t.getFromStateId()) + " -> " + quoteDOT(t.getToStateId());
+        if (separate) {
+            for (const QString& symbol : symbols) {
+                put(edge + " [label=" + quoteDOT(symbol) + "];\n");
+            }
+        } else {
+            put(edge + " [label=" + quoteDOT(symbols.join(",")) + "];\n");
+        }
+    }
+
+    put("}\n");
+}
+
+
+QString AutomatonExporter::quoteJSON(const QString& text) {
+    QString quoted = "\"";
+    for (QChar c : text) {
+        switch (c.unicode()) {
+        case '"': quoted += "\\\""; break;
+        case '\\': quoted += "\\\\"; break;
+        case '\n': quoted += "\\n"; break;
+        case '\r': quoted += "\\r"; break;
+        case '\t': quoted += "\\t"; break;
+        default:
+            if (c.unicode() < 0x20) {
+                quoted += QString("\\u%1").arg(c.unicode(), 4, 16, QChar('0'));
+            } else {
+                quoted += c;
+            }
+            break;
+        }
+    }
+    quoted += '"';
+    return quoted;
+}
+
+void AutomatonExporter::writeJSON(const Automaton* automaton) {
+    put("{\n");
+    put("  \"format\": \"automaton-designer\",\n");
+    put("  \"version\": 1,\n");
+    put("  \"name\": " + quoteJSON(automaton->getName()) + ",\n");
+    put(automaton->isDFA() ? "  \"type\": \"DFA\",\n" : "  \"type\": \"NFA\",\n");
+    put("  \"initial\": " + quoteJSON(automaton->getInitialStateId()) + ",\n");
+
+    put("  \"states\": [");
+    const QVector<State>& states = automaton->getStates();
+    for (int i = 0; i < states.size(); ++i) {
+        const State& state = states[i];
+        put(QString(i == 0 ? "\n    " : ",\n    ") +
+            "{\"id\": " + quoteJSON(state.getId()) +
+            ", \"label\": " + quoteJSON(state.getLabel()) +
+            ", \"x\": " + QString::number(state.getPosition().x()) +
+            ", \"y\": " + QString::number(state.getPosition().y()) +
+            ", \"initial\": " + (state.getIsInitial() ? "true" : "false") +
+            ", \"final\": " + (state.getIsFinal() ? "true" : "false") + "}");
+    }
+    put("\n  ],\n");
+
+    put("  \"transitions\": [");
+    const QVector<Transition>& transitions = automaton->getTransitions();
+    for (int i = 0; i < transitions.size(); ++i) {
+        const Transition& t = transitions[i];
+        QStringList symbols;
+        for (const QString& symbol : sortedSymbols(t)) {
+            symbols.append(quoteJSON(isEpsilon(symbol) ? QString("ε") : symbol));
+        }
+        put(QString(i == 0 ? "\n    " : ",\n    ") +
+            "{\"from\": " + quoteJSON(t.getFromStateId()) +
+            ", \"to\": " + quoteJSON(t.getToStateId()) +
+            ", \"symbols\": [" + symbols.join(", ") + "]}");
+    }
+    put("\n  ]\n");
+    put("}\n");
+}
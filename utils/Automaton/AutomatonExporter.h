@@ -0,0 +1,42 @@
+#ifndef AUTOMATONEXPORTER_H
+#define AUTOMATONEXPORTER_H
+
+#include "./src/models/Automaton/Automaton.h"
+#include "AutomatonImporter.h"
+#include <QIODevice>
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+
+class AutomatonExporter {
+public:
+    typedef AutomatonImporter::Format Format;
+
+    static constexpr int CHUNK_SIZE = 64 * 1024;
+
+    AutomatonExporter();
+
+    bool exportTo(const Automaton* automaton, QIODevice* device, Format format, QString* error = nullptr);
+    bool exportFile(const Automaton* automaton, const QString& fileName, QString* error = nullptr);
+
+private:
+    QIODevice* device;
+    QByteArray buffer;
+    bool failed;
+
+    void put(const QString& text);
+    void put(const char* text);
+    bool flush();
+
+    static bool isEpsilon(const QString& symbol);
+    static QStringList sortedSymbols(const Transition& transition);
+
+    void writeJFLAP(const Automaton* automaton);
+    void writeDOT(const Automaton* automaton);
+    void writeJSON(const Automaton* automaton);
+
+    static QString quoteDOT(const QString& text);
+    static QString quoteJSON(const QString& text);
+};
+
+#endif
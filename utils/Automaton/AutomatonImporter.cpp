@@ -0,0 +1,799 @@
+#include "AutomatonImporter.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QXmlStreamReader>
+#include <QStringList>
+
+AutomatonImporter::AutomatonImporter()
+    : type(AutomatonType::NFA), typeKnown(false), device(nullptr), cursor(0), line(1),
+      pendingQuoted(false), hasPendingToken(false) {}
+
+AutomatonImporter::Format AutomatonImporter::formatForFile(const QString& fileName) {
+    QString suffix = QFileInfo(fileName).suffix().toLower();
+    if (suffix == "jff") return Format::JFLAP;
+    if (suffix == "dot" || suffix == "gv") return Format::DOT;
+    if (suffix == "json") return Format::JSON;
+    return Format::Unknown;
+}
+
+Automaton* AutomatonImporter::importFile(const QString& fileName, const QString& id, QString* errorOut) {
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (errorOut) *errorOut = QString("Could not open %1").arg(fileName);
+        return nullptr;
+    }
+
+    Automaton* automaton = import(&file, formatForFile(fileName), id, errorOut);
+    if (automaton && automaton->getName() == "Imported automaton") {
+        automaton->setName(QFileInfo(fileName).completeBaseName());
+    }
+    return automaton;
+}
+
+Automaton* AutomatonImporter::import(QIODevice* source, Format format, const QString& id, QString* errorOut) {
+    reset(source);
+
+    bool ok = false;
+    switch (format) {
+    case Format::JFLAP: ok = readJFLAP(); break;
+    case Format::DOT: ok = readDOT(); break;
+    case Format::JSON: ok = readJSON(); break;
+    case Format::Unknown: ok = fail("Unknown file format (expected .jff, .dot, .gv or .json)."); break;
+    }
+
+    Automaton* automaton = ok && error.isEmpty() ? finish(id) : nullptr;
+    if (!automaton && errorOut) {
+        *errorOut = error;
+    }
+    reset(nullptr);
+    return automaton;
+}
+
+void AutomatonImporter::reset(QIODevice* source) {
+    states.clear();
+    stateIndex.clear();
+    transitions.clear();
+    name.clear();
+    initialId.clear();
+    type = AutomatonType::NFA;
+    typeKnown = false;
+    error.clear();
+    device = source;
+    chunk.clear();
+    cursor = 0;
+    line = 1;
+    nodeDefaults.clear();
+    startMarkers.clear();
+    pendingToken.clear();
+    hasPendingToken = false;
+}
+
+bool AutomatonImporter::fail(const QString& message) {
+    if (error.isEmpty()) {
+        error = message;
+    }
+    return false;
+}
+
+int AutomatonImporter::ensureState(const QString& id) {
+    int index = stateIndex.value(id, -1);
+    if (index < 0) {
+        index = states.size();
+        QPointF position(100 + (index % 10) * 120, 100 + (index / 10) * 120);
+        states.append(State(id, id, position));
+        stateIndex.insert(id, index);
+    }
+    return index;
+}
+
+QString AutomatonImporter::normalizeSymbol(const QString& symbol) {
+    if (symbol.isEmpty() || symbol == "ε" || symbol == "λ" || symbol == "epsilon") {
+        return "E";
+    }
+    return symbol;
+}
+
+Automaton* AutomatonImporter::finish(const QString& id) {
+    if (!initialId.isEmpty()) {
+        int index = stateIndex.value(initialId, -1);
+        if (index < 0) {
+            fail(QString("Initial state '%1' does not exist.").arg(initialId));
+            return nullptr;
+        }
+        for (auto& state : states) {
+            state.setIsInitial(false);
+        }
+        states[index].setIsInitial(true);
+    }
+
+    QString automatonName = name.isEmpty() ? QString("Imported automaton") : name;
+    Automaton* automaton = new Automaton(id, automatonName, typeKnown ? type : AutomatonType::NFA);
+    if (!automaton->loadBulk(std::move(states), std::move(transitions))) {
+        fail("File does not describe a valid automaton (duplicate states, dangling transitions, "
+             "or a DFA that is not deterministic).");
+        delete automaton;
+        return nullptr;
+    }
+
+    if (!typeKnown) {
+        automaton->detectType();
+    }
+    return automaton;
+}
+
+int AutomatonImporter::peekByte() {
+    if (cursor >= chunk.size()) {
+        chunk = device->read(CHUNK_SIZE);
+        cursor = 0;
+        if (chunk.isEmpty()) {
+            return -1;
+        }
+    }
+    return uchar(chunk.at(cursor));
+}
+
+int AutomatonImporter::nextByte() {
+    int c = peekByte();
+    if (c >= 0) {
+        ++cursor;
+        if (c == '\n') {
+            ++line;
+        }
+    }
+    return c;
+}
+
+
+bool AutomatonImporter::readJFLAP() {
+    QXmlStreamReader xml(device);
+    QHash<QString, QString> jflapIds;
+
+    while (!xml.atEnd()) {
+        xml.readNext();
+        if (!xml.isStartElement()) {
+            continue;
+        }
+
+        if (xml.name() == QLatin1String("type")) {
+            QString kind = xml.readElementText().trimmed();
+            if (kind != "fa") {
+                return fail(QString("JFLAP '%1' machines are not finite automata.").arg(kind));
+            }
+        } else if (xml.name() == QLatin1String("state")) {
+            QString jflapId = xml.attributes().value("id").toString();
+            QString stateId = xml.attributes().value("name").toString();
+            if (stateId.isEmpty() || stateIndex.contains(stateId)) {
+                stateId = "q" + jflapId;
+            }
+            if (jflapId.isEmpty() || jflapIds.contains(jflapId) || stateIndex.contains(stateId)) {
+                return fail(QString("Duplicate or missing state id at line %1.").arg(xml.lineNumber()));
+            }
+
+            int index = ensureState(stateId);
+            jflapIds.insert(jflapId, stateId);
+            QPointF position = states[index].getPosition();
+
+            while (xml.readNextStartElement()) {
+                if (xml.name() == QLatin1String("x")) {
+                    position.setX(xml.readElementText().toDouble());
+                } else if (xml.name() == QLatin1String("y")) {
+                    position.setY(xml.readElementText().toDouble());
+                } else if (xml.name() == QLatin1String("label")) {
+                    states[index].setLabel(xml.readElementText());
+                } else if (xml.name() == QLatin1String("initial")) {
+                    states[index].setIsInitial(true);
+                    xml.skipCurrentElement();
+                } else if (xml.name() == QLatin1String("final")) {
+                    states[index].setIsFinal(true);
+                    xml.skipCurrentElement();
+                } else {
+                    xml.skipCurrentElement();
+                }
+            }
+            states[index].setPosition(position);
+        } else if (xml.name() == QLatin1String("transition")) {
+            QString from, to, read;
+            while (xml.readNextStartElement()) {
+                if (xml.name() == QLatin1String("from")) {
+                    from = xml.readElementText().trimmed();
+                } else if (xml.name() == QLatin1String("to")) {
+                    to = xml.readElementText().trimmed();
+                } else if (xml.name() == QLatin1String("read")) {
+                    read = xml.readElementText();
+                } else {
+                    xml.skipCurrentElement();
+                }
+            }
+
+            if (!jflapIds.contains(from) || !jflapIds.contains(to)) {
+                return fail(QString("Transition at line %1 refers to an unknown state.").arg(xml.lineNumber()));
+            }
+            transitions.append(Transition(jflapIds.value(from), jflapIds.value(to), normalizeSymbol(read)));
+        }
+    }
+
+    if (xml.hasError()) {
+        return fail(QString("XML error at line %1: %2").arg(xml.lineNumber()).arg(xml.errorString()));
+    }
+    return true;
+}
+
+
+bool AutomatonImporter::isDOTPunctuation(const QString& token) {
+    return token == "{" || token == "}" || token == "[" || token == "]" || token == "=" ||
+           token == ";" || token == "," || token == ":" || token == "->" || token == "--";
+}
+
+void AutomatonImporter::skipDOTSpace() {
+    while (true) {
+        int c = peekByte();
+        if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+            nextByte();
+        } else if (c == '#') {
+            while (c >= 0 && c != '\n') c = nextByte();
+        } else if (c == '/') {
+            nextByte();
+            int kind = nextByte();
+            if (kind == '/') {
+                while (c >= 0 && c != '\n') c = nextByte();
+            } else if (kind == '*') {
+                int previous = 0;
+                while ((c = nextByte()) >= 0 && !(previous == '*' && c == '/')) previous = c;
+            } else {
+                fail(QString("Unexpected '/' at line %1.").arg(line));
+                return;
+            }
+        } else {
+            return;
+        }
+    }
+}
+
+bool AutomatonImporter::readDOTToken(QString& token, bool& quoted) {
+    if (hasPendingToken) {
+        hasPendingToken = false;
+        token = pendingToken;
+        quoted = pendingQuoted;
+        return true;
+    }
+
+    skipDOTSpace();
+    if (!error.isEmpty()) {
+        return false;
+    }
+    int c = nextByte();
+    if (c < 0) {
+        return false;
+    }
+
+    QByteArray bytes;
+    quoted = false;
+
+    if (c == '"') {
+        quoted = true;
+        while ((c = nextByte()) >= 0 && c != '"') {
+            if (c == '\\') {
+                int escaped = nextByte();
+                if (escaped == '\n') continue;
+                if (escaped != '"' && escaped != '\\') bytes += '\\';
+                if (escaped >= 0) bytes += char(escaped);
+                continue;
+            }
+            bytes += char(c);
+        }
+    } else if (c == '<') {
+        quoted = true;
+        int depth = 1;
+        while ((c = nextByte()) >= 0) {
+            if (c == '<') depth++;
+            if (c == '>' && --depth == 0) break;
+            bytes += char(c);
+        }
+    } else if (c == '-' && (peekByte() == '>' || peekByte() == '-')) {
+        bytes += char(c);
+        bytes += char(nextByte());
+    } else if (QByteArray("{}[]=;,:").contains(char(c))) {
+        bytes += char(c);
+    } else {
+        if (c == '-' && !isdigit(peekByte()) && peekByte() != '.') {
+            fail(QString("Unexpected '-' at line %1.").arg(line));
+            return false;
+        }
+        bytes += char(c);
+        while ((c = peekByte()) >= 0 && (c >= 0x80 || isalnum(c) || c == '_' || c == '.')) {
+            bytes += char(nextByte());
+        }
+    }
+
+    token = QString::fromUtf8(bytes);
+    return true;
+}
+
+void AutomatonImporter::unreadDOTToken(const QString& token, bool quoted) {
+    pendingToken = token;
+    pendingQuoted = quoted;
+    hasPendingToken = true;
+}
+
+void AutomatonImporter::skipDOTPort() {
+    QString token;
+    bool quoted;
+    for (int part = 0; part < 2; ++part) {
+        if (!readDOTToken(token, quoted)) {
+            return;
+        }
+        if (quoted || token != ":") {
+            unreadDOTToken(token, quoted);
+            return;
+        }
+        readDOTToken(token, quoted);
+    }
+}
+
+bool AutomatonImporter::readDOTAttributes(QHash<QString, QString>& attributes) {
+    QString token;
+    bool quoted;
+
+    while (readDOTToken(token, quoted)) {
+        if (quoted || token != "[") {
+            unreadDOTToken(token, quoted);
+            return true;
+        }
+
+        while (true) {
+            if (!readDOTToken(token, quoted)) {
+                return fail("Unterminated attribute list in DOT file.");
+            }
+            if (!quoted && (token == "," || token == ";")) continue;
+            if (!quoted && token == "]") break;
+            if (!quoted && isDOTPunctuation(token)) {
+                return fail(QString("Unexpected '%1' in attribute list at line %2.").arg(token).arg(line));
+            }
+
+            QString key = token.toLower();
+            QString value;
+            if (!readDOTToken(token, quoted)) {
+                return fail("Unterminated attribute list in DOT file.");
+            }
+            if (!quoted && token == "=") {
+                if (!readDOTToken(value, quoted)) {
+                    return fail("Unterminated attribute list in DOT file.");
+                }
+            } else {
+                unreadDOTToken(token, quoted);
+            }
+            attributes.insert(key, value);
+        }
+    }
+    return true;
+}
+
+bool AutomatonImporter::readDOT() {
+    QString token;
+    bool quoted;
+
+    if (!readDOTToken(token, quoted)) {
+        return fail("DOT file is empty.");
+    }
+    if (!quoted && token.toLower() == "strict") {
+        readDOTToken(token, quoted);
+    }
+
+    QString kind = token.toLower();
+    if (quoted || (kind != "digraph" && kind != "graph")) {
+        return fail("DOT file must start with 'digraph' or 'graph'.");
+    }
+
+    if (!readDOTToken(token, quoted)) {
+        return fail("Unexpected end of DOT file.");
+    }
+    if (quoted || token != "{") {
+        name = token;
+        if (!readDOTToken(token, quoted) || quoted || token != "{") {
+            return fail("Expected '{' after the graph name.");
+        }
+    }
+
+    if (!readDOTStatements(0)) {
+        return false;
+    }
+
+    bool hasInitial = false;
+    for (const auto& state : states) {
+        hasInitial = hasInitial || state.getIsInitial();
+    }
+    if (!hasInitial && !states.isEmpty()) {
+        states[0].setIsInitial(true);
+    }
+    return true;
+}
+
+bool AutomatonImporter::readDOTStatements(int depth) {
+    if (depth > MAX_NESTING) {
+        return fail("DOT subgraphs are nested too deeply.");
+    }
+
+    QString token;
+    bool quoted;
+
+    while (readDOTToken(token, quoted)) {
+        if (!quoted && token == "}") {
+            return true;
+        }
+        if (!quoted && token == ";") {
+            continue;
+        }
+        if (!quoted && token == "{") {
+            if (!readDOTStatements(depth + 1)) return false;
+            continue;
+        }
+
+        QString keyword = quoted ? QString() : token.toLower();
+        if (keyword == "subgraph") {
+            if (!readDOTToken(token, quoted)) break;
+            if (quoted || token != "{") {
+                if (!readDOTToken(token, quoted)) break;
+            }
+            if (quoted || token != "{") {
+                return fail(QString("Expected '{' after subgraph at line %1.").arg(line));
+            }
+            if (!readDOTStatements(depth + 1)) return false;
+            continue;
+        }
+
+        if (keyword == "graph" || keyword == "node" || keyword == "edge") {
+            QHash<QString, QString> attributes;
+            if (!readDOTAttributes(attributes)) return false;
+            if (keyword == "node") {
+                for (auto it = attributes.constBegin(); it != attributes.constEnd(); ++it) {
+                    nodeDefaults.insert(it.key(), it.value());
+                }
+            }
+            continue;
+        }
+
+        if (!quoted && isDOTPunctuation(token)) {
+            return fail(QString("Unexpected '%1' at line %2.").arg(token).arg(line));
+        }
+
+        QStringList chain(token);
+        skipDOTPort();
+        if (!readDOTToken(token, quoted)) break;
+
+        if (!quoted && token == "=") {
+            if (!readDOTToken(token, quoted)) break;
+            continue;
+        }
+
+        while (!quoted && (token == "->" || token == "--")) {
+            if (!readDOTToken(token, quoted)) break;
+            if (!quoted && isDOTPunctuation(token)) {
+                return fail(QString("Subgraph edge endpoints are not supported (line %1).").arg(line));
+            }
+            chain.append(token);
+            skipDOTPort();
+            if (!readDOTToken(token, quoted)) {
+                return fail("Unexpected end of DOT file (missing '}').");
+            }
+        }
+        unreadDOTToken(token, quoted);
+
+        QHash<QString, QString> attributes;
+        if (!readDOTAttributes(attributes)) return false;
+
+        if (chain.size() == 1) {
+            applyNodeAttributes(chain.first(), attributes);
+        } else {
+            for (int i = 0; i + 1 < chain.size(); ++i) {
+                addDOTEdge(chain[i], chain[i + 1], attributes);
+            }
+        }
+    }
+
+    return fail("Unexpected end of DOT file (missing '}').");
+}
+
+void AutomatonImporter::applyNodeAttributes(const QString& node, const QHash<QString, QString>& attributes) {
+    QHash<QString, QString> merged = nodeDefaults;
+    for (auto it = attributes.constBegin(); it != attributes.constEnd(); ++it) {
+        merged.insert(it.key(), it.value());
+    }
+
+    QString shape = merged.value("shape").toLower();
+    if (shape == "point" || shape == "none" || shape == "plaintext" ||
+        merged.value("style").toLower() == "invis") {
+        if (!stateIndex.contains(node)) {
+            startMarkers.insert(node);
+            return;
+        }
+    }
+
+    int index = ensureState(node);
+    State& state = states[index];
+
+    QString label = merged.value("label");
+    if (!label.isEmpty() && label != "\\N") {
+        state.setLabel(label);
+    }
+    if (shape == "doublecircle" || shape == "doubleoctagon") {
+        state.setIsFinal(true);
+    }
+
+    QStringList pos = merged.value("pos").remove('!').split(',');
+    if (pos.size() == 2) {
+        bool okX, okY;
+        double x = pos[0].trimmed().toDouble(&okX);
+        double y = pos[1].trimmed().toDouble(&okY);
+        if (okX && okY) {
+            state.setPosition(QPointF(x, -y));
+        }
+    }
+}
+
+void AutomatonImporter::addDOTEdge(const QString& from, const QString& to, const QHash<QString, QString>& attributes) {
+    for (const QString& node : {from, to}) {
+        if (!stateIndex.contains(node) && !startMarkers.contains(node)) {
+            applyNodeAttributes(node, QHash<QString, QString>());
+        }
+    }
+
+    if (startMarkers.contains(to)) {
+        return;
+    }
+    if (startMarkers.contains(from)) {
+        states[ensureState(to)].setIsInitial(true);
+        return;
+    }
+
+    QSet<QString> symbols;
+    QString label = attributes.value("label");
+    QStringList parts = label == "," ? QStringList(label) : label.split(',');
+    for (const QString& part : parts) {
+        symbols.insert(normalizeSymbol(part.trimmed()));
+    }
+    transitions.append(Transition(states[ensureState(from)].getId(), states[ensureState(to)].getId(), symbols));
+}
+
+
+void AutomatonImporter::skipJSONSpace() {
+    int c;
+    while ((c = peekByte()) == ' ' || c == '\t' || c == '\n' || c == '\r') {
+        nextByte();
+    }
+}
+
+bool AutomatonImporter::expectJSON(char c) {
+    skipJSONSpace();
+    if (peekByte() != uchar(c)) {
+        return fail(QString("Expected '%1' at line %2.").arg(QLatin1Char(c)).arg(line));
+    }
+    nextByte();
+    return true;
+}
+
+bool AutomatonImporter::readJSONString(QString& value) {
+    skipJSONSpace();
+    if (peekByte() != '"') {
+        return fail(QString("Expected a string at line %1.").arg(line));
+    }
+    nextByte();
+
+    value.clear();
+    QByteArray bytes;
+    while (true) {
+        int c = nextByte();
+        if (c < 0) {
+            return fail("Unterminated string in JSON file.");
+        }
+        if (c == '"') {
+            break;
+        }
+        if (c != '\\') {
+            bytes += char(c);
+            continue;
+        }
+
+        int escaped = nextByte();
+        switch (escaped) {
+        case 'b': bytes += '\b'; break;
+        case 'f': bytes += '\f'; break;
+        case 'n': bytes += '\n'; break;
+        case 'r': bytes += '\r'; break;
+        case 't': bytes += '\t'; break;
+        case 'u': {
+            ushort unit = 0;
+            for (int i = 0; i < 4; ++i) {
+                int hex = nextByte() | 0x20;
+                int digit = (hex >= '0' && hex <= '9') ? hex - '0'
+                          : (hex >= 'a' && hex <= 'f') ? hex - 'a' + 10 : -1;
+                if (digit < 0) {
+                    return fail(QString("Invalid \\u escape at line %1.").arg(line));
+                }
+                unit = ushort(unit * 16 + digit);
+            }
+            value += QString::fromUtf8(bytes);
+            bytes.clear();
+            value += QChar(unit);
+            break;
+        }
+        default:
+            if (escaped < 0) {
+                return fail("Unterminated string in JSON file.");
+            }
+            bytes += char(escaped);
+            break;
+        }
+    }
+
+    value += QString::fromUtf8(bytes);
+    return true;
+}
+
+bool AutomatonImporter::readJSONScalar(QByteArray& value) {
+    skipJSONSpace();
+    value.clear();
+    int c;
+    while ((c = peekByte()) >= 0 && (isalnum(c) || c == '-' || c == '+' || c == '.')) {
+        value += char(nextByte());
+    }
+    if (value.isEmpty()) {
+        return fail(QString("Expected a value at line %1.").arg(line));
+    }
+    return true;
+}
+
+template <typename Field>
+bool AutomatonImporter::readJSONObject(Field field) {
+    if (!expectJSON('{')) {
+        return false;
+    }
+    skipJSONSpace();
+    if (peekByte() == '}') {
+        nextByte();
+        return true;
+    }
+
+    while (true) {
+        QString key;
+        if (!readJSONString(key) || !expectJSON(':') || !field(key)) {
+            return false;
+        }
+        skipJSONSpace();
+        if (peekByte() != ',') {
+            return expectJSON('}');
+        }
+        nextByte();
+    }
+}
+
+template <typename Element>
+bool AutomatonImporter::readJSONArray(Element element) {
+    if (!expectJSON('[')) {
+        return false;
+    }
+    skipJSONSpace();
+    if (peekByte() == ']') {
+        nextByte();
+        return true;
+    }
+
+    while (true) {
+        if (!element()) {
+            return false;
+        }
+        skipJSONSpace();
+        if (peekByte() != ',') {
+            return expectJSON(']');
+        }
+        nextByte();
+    }
+}
+
+bool AutomatonImporter::skipJSONValue(int depth) {
+    if (depth > MAX_NESTING) {
+        return fail("JSON value is nested too deeply.");
+    }
+
+    skipJSONSpace();
+    int c = peekByte();
+    if (c == '"') {
+        QString ignored;
+        return readJSONString(ignored);
+    }
+    if (c == '{') {
+        return readJSONObject([this, depth](const QString&) { return skipJSONValue(depth + 1); });
+    }
+    if (c == '[') {
+        return readJSONArray([this, depth]() { return skipJSONValue(depth + 1); });
+    }
+    QByteArray ignored;
+    return readJSONScalar(ignored);
+}
+
+bool AutomatonImporter::readJSON() {
+    return readJSONObject([this](const QString& key) {
+        if (key == "name") {
+            return readJSONString(name);
+        }
+        if (key == "type") {
+            QString kind;
+            if (!readJSONString(kind)) return false;
+            typeKnown = true;
+            type = kind.toUpper() == "DFA" ? AutomatonType::DFA : AutomatonType::NFA;
+            return true;
+        }
+        if (key == "initial") {
+            return readJSONString(initialId);
+        }
+        if (key == "states") {
+            return readJSONArray([this]() { return readJSONState(); });
+        }
+        if (key == "transitions") {
+            return readJSONArray([this]() { return readJSONTransition(); });
+        }
+        return skipJSONValue();
+    });
+}
+
+bool AutomatonImporter::readJSONState() {
+    QString id, label;
+    QByteArray x, y, initial, final;
+    bool ok = readJSONObject([&](const QString& key) {
+        if (key == "id") return readJSONString(id);
+        if (key == "label") return readJSONString(label);
+        if (key == "x") return readJSONScalar(x);
+        if (key == "y") return readJSONScalar(y);
+        if (key == "initial") return readJSONScalar(initial);
+        if (key == "final") return readJSONScalar(final);
+        return skipJSONValue();
+    });
+    if (!ok) {
+        return false;
+    }
+
+    if (id.isEmpty() || stateIndex.contains(id)) {
+        return fail(QString("Missing or duplicate state id before line %1.").arg(line));
+    }
+
+    State& state = states[ensureState(id)];
+    state.setLabel(label.isEmpty() ? id : label);
+    if (!x.isEmpty() && !y.isEmpty()) {
+        state.setPosition(QPointF(x.toDouble(), y.toDouble()));
+    }
+    state.setIsInitial(initial == "true");
+    state.setIsFinal(final == "true");
+    return true;
+}
+
+bool AutomatonImporter::readJSONTransition() {
+    QString from, to;
+    QSet<QString> symbols;
+    bool ok = readJSONObject([&](const QString& key) {
+        if (key == "from") return readJSONString(from);
+        if (key == "to") return readJSONString(to);
+        if (key == "symbol") {
+            QString symbol;
+            if (!readJSONString(symbol)) return false;
+            symbols.insert(normalizeSymbol(symbol));
+            return true;
+        }
+        if (key == "symbols") {
+            return readJSONArray([&]() {
+                QString symbol;
+                if (!readJSONString(symbol)) return false;
+                symbols.insert(normalizeSymbol(symbol));
+                return true;
+            });
+        }
+        return skipJSONValue();
+    });
+    if (!ok) {
+        return false;
+    }
+
+    if (from.isEmpty() || to.isEmpty() || symbols.isEmpty()) {
+        return fail(QString("Transition before line %1 needs 'from', 'to' and symbols.").arg(line));
+    }
+    transitions.append(Transition(from, to, symbols));
+    return true;
+}
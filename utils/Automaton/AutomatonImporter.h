@@ -0,0 +1,89 @@
+#ifndef AUTOMATONIMPORTER_H
+#define AUTOMATONIMPORTER_H
+
+#include "./src/models/Automaton/Automaton.h"
+#include <QIODevice>
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QSet>
+
+class AutomatonImporter {
+public:
+    enum class Format {
+        Unknown,
+        JFLAP,
+        DOT,
+        JSON
+    };
+
+    static constexpr int CHUNK_SIZE = 64 * 1024;
+    static constexpr int MAX_NESTING = 256;
+
+    AutomatonImporter();
+
+    static Format formatForFile(const QString& fileName);
+
+    Automaton* import(QIODevice* device, Format format, const QString& id, QString* error = nullptr);
+    Automaton* importFile(const QString& fileName, const QString& id, QString* error = nullptr);
+
+private:
+    QVector<State> states;
+    QHash<QString, int> stateIndex;
+    QVector<Transition> transitions;
+    QString name;
+    QString initialId;
+    AutomatonType type;
+    bool typeKnown;
+    QString error;
+
+    QIODevice* device;
+    QByteArray chunk;
+    int cursor;
+    int line;
+
+    void reset(QIODevice* source);
+    bool fail(const QString& message);
+    int ensureState(const QString& id);
+    static QString normalizeSymbol(const QString& symbol);
+    Automaton* finish(const QString& id);
+
+    int peekByte();
+    int nextByte();
+
+
+    bool readJFLAP();
+
+
+    QHash<QString, QString> nodeDefaults;
+    QSet<QString> startMarkers;
+    QString pendingToken;
+    bool pendingQuoted;
+    bool hasPendingToken;
+
+    bool readDOT();
+    bool readDOTStatements(int depth);
+    bool readDOTToken(QString& token, bool& quoted);
+    void unreadDOTToken(const QString& token, bool quoted);
+    bool readDOTAttributes(QHash<QString, QString>& attributes);
+    void skipDOTPort();
+    void skipDOTSpace();
+    static bool isDOTPunctuation(const QString& token);
+    void applyNodeAttributes(const QString& node, const QHash<QString, QString>& attributes);
+    void addDOTEdge(const QString& from, const QString& to, const QHash<QString, QString>& attributes);
+
+
+    bool readJSON();
+    bool readJSONState();
+    bool readJSONTransition();
+    template <typename Field> bool readJSONObject(Field field);
+    template <typename Element> bool readJSONArray(Element element);
+    bool readJSONString(QString& value);
+    bool readJSONScalar(QByteArray& value);
+    bool skipJSONValue(int depth = 0);
+    bool expectJSON(char c);
+    void skipJSONSpace();
+};
+
+#endif
@@ -0,0 +1,139 @@
+#include "AutomatonSearcher.h"
+
+AutomatonSearcher::AutomatonSearcher()
+    : prefixState(-1), matchesEmpty(false) {}
+
+AutomatonSearcher::AutomatonSearcher(const Automaton* automaton)
+    : prefixState(-1), matchesEmpty(false) {
+    setAutomaton(automaton);
+}
+
+bool AutomatonSearcher::setAutomaton(const Automaton* automaton) {
+    requiredPrefix.clear();
+    startClasses.clear();
+    prefixState = -1;
+    matchesEmpty = false;
+
+    if (!dfa.compile(automaton)) {
+        return false;
+    }
+
+    extractPrefilter();
+    return true;
+}
+
+void AutomatonSearcher::extractPrefilter() {
+    int initial = dfa.getInitialState();
+    matchesEmpty = dfa.isAccepting(initial);
+
+    startClasses.fill(false, dfa.getClassCount());
+    for (int c = 1; c < dfa.getClassCount(); ++c) {
+        startClasses[c] = dfa.nextByClass(initial, c) != CompiledDFA::DEAD_STATE;
+    }
+
+
+    int state = initial;
+    while (!dfa.isAccepting(state) && requiredPrefix.length() < dfa.getStateCount()) {
+        int onlyClass = -1;
+        for (int c = 1; c < dfa.getClassCount(); ++c) {
+            if (dfa.nextByClass(state, c) == CompiledDFA::DEAD_STATE) {
+                continue;
+            }
+            if (onlyClass != -1) {
+                onlyClass = -1;
+                break;
+            }
+            onlyClass = c;
+        }
+
+        if (onlyClass < 0) {
+            break;
+        }
+
+        QVector<QChar> members = dfa.getClassMembers(onlyClass);
+        if (members.size() != 1) {
+            break;
+        }
+
+        requiredPrefix += members.first();
+        state = dfa.nextByClass(state, onlyClass);
+    }
+    prefixState = state;
+}
+
+int AutomatonSearcher::nextCandidate(const QString& text, int from) const {
+    if (matchesEmpty) {
+        return from <= text.length() ? from : -1;
+    }
+
+    if (!requiredPrefix.isEmpty()) {
+        return text.indexOf(requiredPrefix, from);
+    }
+
+    const QChar* data = text.constData();
+    int length = text.length();
+    for (int i = from; i < length; ++i) {
+        if (startClasses[dfa.classOf(data[i])]) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int AutomatonSearcher::longestMatchFrom(const QString& text, int pos, int state) const {
+    const QChar* data = text.constData();
+    int length = text.length();
+    int lastAccept = dfa.isAccepting(state) ? pos : -1;
+
+    for (int i = pos; i < length; ++i) {
+        state = dfa.next(state, data[i]);
+        if (state == CompiledDFA::DEAD_STATE) {
+            break;
+        }
+        if (dfa.isAccepting(state)) {
+            lastAccept = i + 1;
+        }
+    }
+
+    return lastAccept;
+}
+
+AutomatonMatch AutomatonSearcher::find(const QString& text, int from) const {
+    if (!isValid() || from < 0 || from > text.length()) {
+        return AutomatonMatch();
+    }
+
+    int pos = from;
+    while ((pos = nextCandidate(text, pos)) >= 0) {
+        int end;
+        if (!requiredPrefix.isEmpty()) {
+            end = longestMatchFrom(text, pos + requiredPrefix.length(), prefixState);
+        } else {
+            end = longestMatchFrom(text, pos, dfa.getInitialState());
+        }
+
+        if (end >= 0) {
+            return AutomatonMatch(pos, end - pos);
+        }
+        ++pos;
+    }
+
+    return AutomatonMatch();
+}
+
+QVector<AutomatonMatch> AutomatonSearcher::findAll(const QString& text) const {
+    QVector<AutomatonMatch> matches;
+    int from = 0;
+
+    while (from <= text.length()) {
+        AutomatonMatch match = find(text, from);
+        if (!match.isValid()) {
+            break;
+        }
+
+        matches.append(match);
+        from = match.length > 0 ? match.end() : match.end() + 1;
+    }
+
+    return matches;
+}
@@ -0,0 +1,47 @@
+#ifndef AUTOMATONSEARCHER_H
+#define AUTOMATONSEARCHER_H
+
+#include "./src/models/Automaton/Automaton.h"
+#include "CompiledDFA.h"
+#include <QString>
+#include <QVector>
+
+struct AutomatonMatch {
+    int start;
+    int length;
+
+    AutomatonMatch(int s = -1, int len = 0) : start(s), length(len) {}
+
+    bool isValid() const { return start >= 0; }
+    int end() const { return start + length; }
+};
+
+
+class AutomatonSearcher {
+public:
+    AutomatonSearcher();
+    explicit AutomatonSearcher(const Automaton* automaton);
+
+    bool setAutomaton(const Automaton* automaton);
+    bool isValid() const { return dfa.isValid(); }
+
+
+    AutomatonMatch find(const QString& text, int from = 0) const;
+    QVector<AutomatonMatch> findAll(const QString& text) const;
+
+    QString getRequiredPrefix() const { return requiredPrefix; }
+    const CompiledDFA& getCompiledDFA() const { return dfa; }
+
+private:
+    CompiledDFA dfa;
+    QString requiredPrefix;
+    int prefixState;
+    bool matchesEmpty;
+    QVector<bool> startClasses;
+
+    void extractPrefilter();
+    int nextCandidate(const QString& text, int from) const;
+    int longestMatchFrom(const QString& text, int pos, int state) const;
+};
+
+#endif
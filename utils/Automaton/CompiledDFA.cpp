@@ -0,0 +1,157 @@
+#include "CompiledDFA.h"
+#include "NFAtoDFA.h"
+#include <QPair>
+#include <algorithm>
+
+CompiledDFA::CompiledDFA()
+    : initialState(-1), stateCount(0), classCount(1), byteClasses(256, 0) {}
+
+void CompiledDFA::clear() {
+    initialState = -1;
+    stateCount = 0;
+    classCount = 1;
+    byteClasses.fill(0);
+    wideClasses.clear();
+    table.clear();
+    accepting.clear();
+    stateIds.clear();
+}
+
+bool CompiledDFA::compile(const Automaton* automaton) {
+    clear();
+
+    if (!automaton || !automaton->isValid()) {
+        return false;
+    }
+
+    if (automaton->isDFA()) {
+        return compileDFA(automaton);
+    }
+
+    NFAtoDFA converter;
+    Automaton* dfa = converter.convert(automaton);
+    if (!dfa) {
+        return false;
+    }
+
+    bool compiled = compileDFA(dfa);
+    delete dfa;
+    return compiled;
+}
+
+bool CompiledDFA::compileDFA(const Automaton* dfa) {
+    const QVector<State>& states = dfa->getStates();
+    int count = states.size();
+    QHash<QString, int> stateIndex;
+    QVector<QString> ids;
+    QVector<bool> acceptingStates;
+    ids.reserve(count);
+    acceptingStates.reserve(count);
+
+    for (int i = 0; i < count; ++i) {
+        stateIndex.insert(states[i].getId(), i);
+        ids.append(states[i].getId());
+        acceptingStates.append(states[i].getIsFinal());
+    }
+
+    int initial = stateIndex.value(dfa->getInitialStateId(), -1);
+    if (initial < 0) {
+        return false;
+    }
+
+
+    QHash<ushort, QVector<qint32>> columns;
+    for (const auto& t : dfa->getTransitions()) {
+        int from = stateIndex.value(t.getFromStateId(), -1);
+        int to = stateIndex.value(t.getToStateId(), -1);
+        if (from < 0 || to < 0) {
+            continue;
+        }
+
+        for (const auto& sym : t.getSymbols()) {
+            if (sym.length() != 1 || sym == "E" || sym == "ε") {
+                continue;
+            }
+
+            QVector<qint32>& column = columns[sym[0].unicode()];
+            if (column.isEmpty()) {
+                column.fill(DEAD_STATE, count);
+            }
+            if (column[from] == DEAD_STATE) {
+                column[from] = to;
+            }
+        }
+    }
+
+    if (!compileFromColumns(initial, acceptingStates, columns)) {
+        return false;
+    }
+    stateIds = ids;
+    return true;
+}
+
+bool CompiledDFA::compileFromColumns(int initial, const QVector<bool>& acceptingStates,
+                                     const QHash<ushort, QVector<qint32>>& columns) {
+    clear();
+
+    stateCount = acceptingStates.size();
+    if (initial < 0 || initial >= stateCount) {
+        clear();
+        return false;
+    }
+    initialState = initial;
+    accepting = acceptingStates;
+
+
+    QVector<QPair<QVector<qint32>, ushort>> sorted;
+    sorted.reserve(columns.size());
+    for (auto it = columns.constBegin(); it != columns.constEnd(); ++it) {
+        sorted.append(qMakePair(it.value(), it.key()));
+    }
+    std::sort(sorted.begin(), sorted.end());
+
+    QVector<const QVector<qint32>*> classColumns;
+    for (int i = 0; i < sorted.size(); ++i) {
+        if (i == 0 || sorted[i].first != sorted[i - 1].first) {
+            classColumns.append(&sorted[i].first);
+        }
+
+        ushort u = sorted[i].second;
+        quint16 symbolClass = quint16(classColumns.size());
+        if (u < 256) {
+            byteClasses[u] = symbolClass;
+        } else {
+            wideClasses.insert(u, symbolClass);
+        }
+    }
+
+    classCount = classColumns.size() + 1;
+    table.fill(DEAD_STATE, stateCount * classCount);
+    for (int c = 1; c < classCount; ++c) {
+        const QVector<qint32>& column = *classColumns[c - 1];
+        for (int s = 0; s < stateCount; ++s) {
+            table[s * classCount + c] = column[s];
+        }
+    }
+
+    return true;
+}
+
+QVector<QChar> CompiledDFA::getClassMembers(int symbolClass) const {
+    QVector<QChar> members;
+    if (symbolClass <= 0) {
+        return members;
+    }
+
+    for (int u = 0; u < 256; ++u) {
+        if (byteClasses[u] == symbolClass) {
+            members.append(QChar(ushort(u)));
+        }
+    }
+    for (auto it = wideClasses.constBegin(); it != wideClasses.constEnd(); ++it) {
+        if (it.value() == symbolClass) {
+            members.append(QChar(it.key()));
+        }
+    }
+    return members;
+}
@@ -0,0 +1,59 @@
+#ifndef COMPILEDDFA_H
+#define COMPILEDDFA_H
+
+#include "./src/models/Automaton/Automaton.h"
+#include <QVector>
+#include <QHash>
+#include <QString>
+#include <QChar>
+
+
+class CompiledDFA {
+public:
+    static constexpr int DEAD_STATE = -1;
+
+    CompiledDFA();
+
+    bool compile(const Automaton* automaton);
+    bool compileFromColumns(int initial, const QVector<bool>& acceptingStates,
+                            const QHash<ushort, QVector<qint32>>& columns);
+    bool isValid() const { return initialState >= 0; }
+    void clear();
+
+    int getInitialState() const { return initialState; }
+    int getStateCount() const { return stateCount; }
+    int getClassCount() const { return classCount; }
+
+    int classOf(QChar c) const {
+        ushort u = c.unicode();
+        return u < 256 ? byteClasses[u] : wideClasses.value(u, 0);
+    }
+
+    int next(int state, QChar c) const {
+        return table[state * classCount + classOf(c)];
+    }
+
+    int nextByClass(int state, int symbolClass) const {
+        return table[state * classCount + symbolClass];
+    }
+
+    bool isAccepting(int state) const { return state >= 0 && accepting[state]; }
+
+
+    QVector<QChar> getClassMembers(int symbolClass) const;
+    QString getStateId(int state) const { return stateIds.value(state); }
+
+private:
+    int initialState;
+    int stateCount;
+    int classCount;
+    QVector<quint16> byteClasses;
+    QHash<ushort, quint16> wideClasses;
+    QVector<qint32> table;
+    QVector<bool> accepting;
+    QVector<QString> stateIds;
+
+    bool compileDFA(const Automaton* dfa);
+};
+
+#endif
@@ -0,0 +1,297 @@
+#include "CompressedDFA.h"
+#include "NFAtoDFA.h"
+#include <algorithm>
+
+CompressedDFA::CompressedDFA()
+    : initialState(-1), stateCount(0), classCount(1), byteClasses(256, 0) {}
+
+void CompressedDFA::clear() {
+    initialState = -1;
+    stateCount = 0;
+    classCount = 1;
+    byteClasses.fill(0);
+    wideClasses.clear();
+    base.clear();
+    defaults.clear();
+    check.clear();
+    targets.clear();
+    accepting.clear();
+}
+
+bool CompressedDFA::compile(const Automaton* automaton) {
+    clear();
+
+    if (!automaton || !automaton->isValid()) {
+        return false;
+    }
+
+    if (automaton->isDFA()) {
+        return compileDFA(automaton);
+    }
+
+    NFAtoDFA converter;
+    Automaton* dfa = converter.convert(automaton);
+    if (!dfa) {
+        return false;
+    }
+
+    bool compiled = compileDFA(dfa);
+    delete dfa;
+    return compiled;
+}
+
+bool CompressedDFA::compileDFA(const Automaton* dfa) {
+    const QVector<State>& states = dfa->getStates();
+    int count = states.size();
+    QHash<QString, int> stateIndex;
+    stateIndex.reserve(count);
+    accepting.resize(count);
+
+    for (int i = 0; i < count; ++i) {
+        stateIndex.insert(states[i].getId(), i);
+        accepting[i] = states[i].getIsFinal();
+    }
+
+    int initial = stateIndex.value(dfa->getInitialStateId(), -1);
+    if (initial < 0) {
+        accepting.clear();
+        return false;
+    }
+
+
+    QHash<ushort, Row> columns;
+    for (const auto& t : dfa->getTransitions()) {
+        int from = stateIndex.value(t.getFromStateId(), -1);
+        int to = stateIndex.value(t.getToStateId(), -1);
+        if (from < 0 || to < 0) {
+            continue;
+        }
+
+        for (const auto& sym : t.getSymbols()) {
+            if (sym.length() != 1 || sym == "E" || sym == "ε") {
+                continue;
+            }
+            columns[sym[0].unicode()].append(qMakePair(qint32(from), qint32(to)));
+        }
+    }
+
+    QVector<QPair<Row, ushort>> sorted;
+    sorted.reserve(columns.size());
+    for (auto it = columns.begin(); it != columns.end(); ++it) {
+        Row column = it.value();
+        std::sort(column.begin(), column.end());
+        sorted.append(qMakePair(column, it.key()));
+    }
+    std::sort(sorted.begin(), sorted.end());
+
+
+    QVector<Row> rows(count);
+    for (int i = 0; i < sorted.size(); ++i) {
+        if (i == 0 || sorted[i].first != sorted[i - 1].first) {
+            int symbolClass = classCount++;
+            for (const auto& entry : sorted[i].first) {
+                Row& row = rows[entry.first];
+                if (row.isEmpty() || row.last().first != symbolClass) {
+                    row.append(qMakePair(qint32(symbolClass), entry.second));
+                }
+            }
+        }
+
+        ushort u = sorted[i].second;
+        quint16 symbolClass = quint16(classCount - 1);
+        if (u < 256) {
+            byteClasses[u] = symbolClass;
+        } else {
+            wideClasses.insert(u, symbolClass);
+        }
+    }
+
+    stateCount = count;
+    initialState = initial;
+    chooseDefaults(rows);
+    pack(rows);
+    return true;
+}
+
+int CompressedDFA::overrides(const Row& row, const Row& fallback, Row* result) {
+    int i = 0, j = 0, count = 0;
+    while (i < row.size() || j < fallback.size()) {
+        if (j >= fallback.size() || (i < row.size() && row[i].first < fallback[j].first)) {
+            if (result) result->append(row[i]);
+            ++i;
+            ++count;
+        } else if (i >= row.size() || fallback[j].first < row[i].first) {
+            if (result) result->append(qMakePair(fallback[j].first, qint32(DEAD_STATE)));
+            ++j;
+            ++count;
+        } else {
+            if (row[i].second != fallback[j].second) {
+                if (result) result->append(row[i]);
+                ++count;
+            }
+            ++i;
+            ++j;
+        }
+    }
+    return count;
+}
+
+void CompressedDFA::chooseDefaults(QVector<Row>& rows) {
+    defaults.fill(-1, stateCount);
+    QVector<int> window;
+
+    for (int s = 0; s < stateCount; ++s) {
+        if (rows[s].size() < 2) {
+            continue;
+        }
+
+        int best = -1;
+        int bestCost = rows[s].size();
+        for (int candidate : window) {
+            int cost = overrides(rows[s], rows[candidate], nullptr);
+            if (cost < bestCost) {
+                best = candidate;
+                bestCost = cost;
+            }
+        }
+
+        if (best >= 0) {
+            Row reduced;
+            reduced.reserve(bestCost);
+            overrides(rows[s], rows[best], &reduced);
+            rows[s] = reduced;
+            defaults[s] = best;
+            continue;
+        }
+
+        window.append(s);
+        if (window.size() > DEFAULT_WINDOW) {
+            window.removeFirst();
+        }
+    }
+}
+
+void CompressedDFA::pack(const QVector<Row>& rows) {
+    QVector<int> order(stateCount);
+    for (int s = 0; s < stateCount; ++s) {
+        order[s] = s;
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [&rows](int a, int b) { return rows[a].size() > rows[b].size(); });
+
+    base.fill(0, stateCount);
+    check.clear();
+    targets.clear();
+    QVector<int> freeLink;
+    int highestBase = 0;
+
+    auto findFree = [&freeLink](int slot) {
+        int root = slot;
+        while (root < freeLink.size() && freeLink[root] != root) {
+            root = freeLink[root];
+        }
+        while (slot < freeLink.size() && freeLink[slot] != slot) {
+            int next = freeLink[slot];
+            freeLink[slot] = root;
+            slot = next;
+        }
+        return root;
+    };
+
+    for (int s : order) {
+        const Row& row = rows[s];
+        if (row.isEmpty()) {
+            break;
+        }
+
+        int offset = 0;
+        while (true) {
+            offset = findFree(offset + row.first().first) - row.first().first;
+            bool fits = true;
+            for (const auto& entry : row) {
+                int slot = offset + entry.first;
+                if (slot < check.size() && check[slot] != DEAD_STATE) {
+                    fits = false;
+                    break;
+                }
+            }
+            if (fits) {
+                break;
+            }
+            ++offset;
+        }
+
+        int needed = offset + row.last().first + 1;
+        if (needed > check.size()) {
+            for (int slot = check.size(); slot < needed; ++slot) {
+                freeLink.append(slot);
+            }
+            check.resize(needed, DEAD_STATE);
+            targets.resize(needed, DEAD_STATE);
+        }
+        for (const auto& entry : row) {
+            int slot = offset + entry.first;
+            check[slot] = s;
+            targets[slot] = entry.second;
+            freeLink[slot] = slot + 1;
+        }
+
+        base[s] = offset;
+        highestBase = qMax(highestBase, offset);
+    }
+
+    check.resize(highestBase + classCount, DEAD_STATE);
+    targets.resize(highestBase + classCount, DEAD_STATE);
+    check.squeeze();
+    targets.squeeze();
+}
+
+bool CompressedDFA::accepts(const QString& input) const {
+    if (!isValid()) {
+        return false;
+    }
+
+    int state = initialState;
+    for (QChar c : input) {
+        state = next(state, c);
+        if (state == DEAD_STATE) {
+            return false;
+        }
+    }
+    return accepting[state];
+}
+
+int CompressedDFA::longestPrefix(const QString& text, int from) const {
+    if (!isValid() || from < 0 || from > text.length()) {
+        return -1;
+    }
+
+    const QChar* data = text.constData();
+    int length = text.length();
+    int state = initialState;
+    int last = accepting[state] ? 0 : -1;
+
+    for (int i = from; i < length; ++i) {
+        state = next(state, data[i]);
+        if (state == DEAD_STATE) {
+            break;
+        }
+        if (accepting[state]) {
+            last = i + 1 - from;
+        }
+    }
+    return last;
+}
+
+qint64 CompressedDFA::memoryBytes() const {
+    qint64 bytes = sizeof(CompressedDFA);
+    bytes += qint64(byteClasses.size()) * sizeof(quint16);
+    bytes += qint64(wideClasses.size()) * (sizeof(ushort) + sizeof(quint16) + 2 * sizeof(void*));
+    bytes += qint64(base.size() + defaults.size() + check.size() + targets.size()) * sizeof(qint32);
+    bytes += qint64(accepting.size()) * sizeof(bool);
+    return bytes;
+}
+
+qint64 CompressedDFA::denseBytes() const {
+    return qint64(stateCount) * classCount * sizeof(qint32) + qint64(stateCount) * sizeof(bool);
+}
@@ -0,0 +1,79 @@
+#ifndef COMPRESSEDDFA_H
+#define COMPRESSEDDFA_H
+
+#include "./src/models/Automaton/Automaton.h"
+#include <QVector>
+#include <QHash>
+#include <QPair>
+#include <QChar>
+
+
+class CompressedDFA {
+public:
+    static constexpr int DEAD_STATE = -1;
+    static constexpr int DEFAULT_WINDOW = 8;
+
+    CompressedDFA();
+
+    bool compile(const Automaton* automaton);
+    bool isValid() const { return initialState >= 0; }
+    void clear();
+
+    int getInitialState() const { return initialState; }
+    int getStateCount() const { return stateCount; }
+    int getClassCount() const { return classCount; }
+    int getSlotCount() const { return check.size(); }
+
+    int classOf(QChar c) const {
+        ushort u = c.unicode();
+        return u < 256 ? byteClasses[u] : wideClasses.value(u, 0);
+    }
+
+    int nextByClass(int state, int symbolClass) const {
+        int slot = base[state] + symbolClass;
+        if (check[slot] == state) {
+            return targets[slot];
+        }
+
+        int fallback = defaults[state];
+        if (fallback < 0) {
+            return DEAD_STATE;
+        }
+        slot = base[fallback] + symbolClass;
+        return check[slot] == fallback ? targets[slot] : DEAD_STATE;
+    }
+
+    int next(int state, QChar c) const {
+        return nextByClass(state, classOf(c));
+    }
+
+    bool isAccepting(int state) const { return state >= 0 && accepting[state]; }
+
+    bool accepts(const QString& input) const;
+    int longestPrefix(const QString& text, int from = 0) const;
+
+
+    qint64 memoryBytes() const;
+    qint64 denseBytes() const;
+
+private:
+    typedef QVector<QPair<qint32, qint32>> Row;
+
+    int initialState;
+    int stateCount;
+    int classCount;
+    QVector<quint16> byteClasses;
+    QHash<ushort, quint16> wideClasses;
+    QVector<qint32> base;
+    QVector<qint32> defaults;
+    QVector<qint32> check;
+    QVector<qint32> targets;
+    QVector<bool> accepting;
+
+    bool compileDFA(const Automaton* dfa);
+    static int overrides(const Row& row, const Row& fallback, Row* result);
+    void chooseDefaults(QVector<Row>& rows);
+    void pack(const QVector<Row>& rows);
+};
+
+#endif
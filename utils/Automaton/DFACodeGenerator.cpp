@@ -0,0 +1,237 @@
+#include "DFACodeGenerator.h"
+#include <QMap>
+
+DFACodeGenerator::DFACodeGenerator() {}
+
+QString DFACodeGenerator::sanitizeIdentifier(const QString& name) {
+    QString result;
+    for (QChar c : name) {
+        if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_') {
+            result += c;
+        } else if (!result.isEmpty() && !result.endsWith('_')) {
+            result += '_';
+        }
+    }
+
+    while (result.endsWith('_')) {
+        result.chop(1);
+    }
+    if (result.isEmpty()) {
+        return "dfa_matcher";
+    }
+    if (result[0].isDigit()) {
+        result.prepend("dfa_");
+    }
+    return result;
+}
+
+QString DFACodeGenerator::hex(uint value) {
+    return QString("0x%1").arg(value, 0, 16);
+}
+
+QString DFACodeGenerator::generate(const Automaton* automaton, Style style,
+                                   const QString& namespaceName, QString* error) {
+    if (!automaton || !dfa.compile(automaton)) {
+        if (error) *error = "Automaton is not valid (it needs states and an initial state).";
+        return QString();
+    }
+
+    collectReachableStates();
+
+    QString ns = sanitizeIdentifier(namespaceName.isEmpty() ? automaton->getName() : namespaceName);
+    QString guard = ns.toUpper() + "_MATCHER_H";
+
+    QString out;
+    out += QString("// Matcher for automaton \"%1\", generated by the Automaton Designer.\n").arg(automaton->getName());
+    out += QString("// %1 states, %2 symbol classes, %3 variant. Needs only the C++17 standard library.\n")
+               .arg(order.size())
+               .arg(dfa.getClassCount())
+               .arg(style == Style::DirectCoded ? "direct-coded" : "table-driven");
+    out += QString("#ifndef %1\n#define %1\n\n").arg(guard);
+    out += "#include <cstddef>\n#include <cstdint>\n#include <type_traits>\n\n";
+    out += QString("namespace %1 {\n\n").arg(ns);
+
+    out += generateClassMap();
+    out += "template <typename CharT>\n"
+           "constexpr std::uint32_t codeUnit(CharT c) noexcept {\n"
+           "    return static_cast<std::uint32_t>(static_cast<std::make_unsigned_t<CharT>>(c));\n"
+           "}\n\n";
+
+    out += (style == Style::DirectCoded) ? generateDirectCoded() : generateTableDriven();
+
+    out += "template <typename CharT>\n";
+    out += (style == Style::DirectCoded) ? "inline " : "constexpr ";
+    out += "bool matches(const CharT* s, std::size_t n) noexcept {\n"
+           "    return longestPrefix(s, n) == static_cast<std::ptrdiff_t>(n);\n"
+           "}\n\n";
+
+    out += QString("}  // namespace %1\n\n#endif  // %2\n").arg(ns).arg(guard);
+    return out;
+}
+
+void DFACodeGenerator::collectReachableStates() {
+    order.clear();
+    renumbered.fill(-1, dfa.getStateCount());
+
+    int initial = dfa.getInitialState();
+    renumbered[initial] = 0;
+    order.append(initial);
+
+    for (int i = 0; i < order.size(); ++i) {
+        for (int c = 1; c < dfa.getClassCount(); ++c) {
+            int next = dfa.nextByClass(order[i], c);
+            if (next != CompiledDFA::DEAD_STATE && renumbered[next] < 0) {
+                renumbered[next] = order.size();
+                order.append(next);
+            }
+        }
+    }
+}
+
+QString DFACodeGenerator::generateClassMap() const {
+    QString out = "constexpr std::uint16_t kByteClass[256] = {\n";
+    QMap<uint, int> wide;
+
+    for (int c = 1; c < dfa.getClassCount(); ++c) {
+        for (QChar member : dfa.getClassMembers(c)) {
+            if (member.unicode() >= 256) {
+                wide.insert(member.unicode(), c);
+            }
+        }
+    }
+
+    for (int u = 0; u < 256; ++u) {
+        if (u % 16 == 0) {
+            out += "    ";
+        }
+        out += QString::number(dfa.classOf(QChar(ushort(u))));
+        out += (u == 255) ? "\n" : (u % 16 == 15 ? ",\n" : ", ");
+    }
+    out += "};\n\n";
+
+    out += "constexpr int classOf(std::uint32_t c) noexcept {\n"
+           "    if (c < 256) {\n"
+           "        return kByteClass[c];\n"
+           "    }\n";
+    if (!wide.isEmpty()) {
+        out += "    switch (c) {\n";
+        for (auto it = wide.constBegin(); it != wide.constEnd(); ++it) {
+            out += QString("    case %1: return %2;\n").arg(hex(it.key())).arg(it.value());
+        }
+        out += "    default: break;\n    }\n";
+    }
+    out += "    return 0;\n}\n\n";
+    return out;
+}
+
+QString DFACodeGenerator::generateDirectCoded() const {
+    int classCount = dfa.getClassCount();
+    QVector<bool> referenced(order.size(), false);
+    for (int s : order) {
+        for (int c = 1; c < classCount; ++c) {
+            int next = dfa.nextByClass(s, c);
+            if (next != CompiledDFA::DEAD_STATE) {
+                referenced[renumbered[next]] = true;
+            }
+        }
+    }
+
+    QString out = "template <typename CharT>\n"
+                  "inline std::ptrdiff_t longestPrefix(const CharT* s, std::size_t n) noexcept {\n"
+                  "    std::size_t i = 0;\n"
+                  "    std::ptrdiff_t last = -1;\n";
+
+    for (int index = 0; index < order.size(); ++index) {
+        int s = order[index];
+        out += "\n";
+        if (referenced[index]) {
+            out += QString("s%1:\n").arg(index);
+        }
+        out += QString("    // state %1\n").arg(dfa.getStateId(s));
+        if (dfa.isAccepting(s)) {
+            out += "    last = static_cast<std::ptrdiff_t>(i);\n";
+        }
+
+        QMap<int, QVector<int>> targets;
+        for (int c = 1; c < classCount; ++c) {
+            int next = dfa.nextByClass(s, c);
+            if (next != CompiledDFA::DEAD_STATE) {
+                targets[renumbered[next]].append(c);
+            }
+        }
+
+        if (targets.isEmpty()) {
+            out += "    return last;\n";
+            continue;
+        }
+
+        out += "    if (i == n) {\n        return last;\n    }\n";
+        out += "    switch (classOf(codeUnit(s[i++]))) {\n";
+        for (auto it = targets.constBegin(); it != targets.constEnd(); ++it) {
+            out += "   ";
+            for (int c : it.value()) {
+                out += QString(" case %1:").arg(c);
+            }
+            out += QString(" goto s%1;\n").arg(it.key());
+        }
+        out += "    default: return last;\n    }\n";
+    }
+
+    out += "}\n\n";
+    return out;
+}
+
+QString DFACodeGenerator::generateTableDriven() const {
+    int classCount = dfa.getClassCount();
+    int stateCount = order.size();
+    QString cell = (stateCount < 32768) ? "std::int16_t" : "std::int32_t";
+
+    QString out;
+    out += QString("constexpr int kStateCount = %1;\n").arg(stateCount);
+    out += QString("constexpr int kClassCount = %1;\n").arg(classCount);
+    out += "constexpr int kInitialState = 0;\n\n";
+
+    out += QString("constexpr %1 kTransitions[kStateCount][kClassCount] = {\n").arg(cell);
+    for (int index = 0; index < stateCount; ++index) {
+        int s = order[index];
+        out += "    {";
+        for (int c = 0; c < classCount; ++c) {
+            int next = (c == 0) ? CompiledDFA::DEAD_STATE : dfa.nextByClass(s, c);
+            out += QString::number(next == CompiledDFA::DEAD_STATE ? -1 : renumbered[next]);
+            if (c + 1 < classCount) {
+                out += ", ";
+            }
+        }
+        out += (index + 1 < stateCount) ? "},\n" : "}\n";
+    }
+    out += "};\n\n";
+
+    out += "constexpr bool kAccepting[kStateCount] = {";
+    for (int index = 0; index < stateCount; ++index) {
+        if (index % 16 == 0) {
+            out += "\n    ";
+        }
+        out += dfa.isAccepting(order[index]) ? "true" : "false";
+        if (index + 1 < stateCount) {
+            out += (index % 16 == 15) ? "," : ", ";
+        }
+    }
+    out += "\n};\n\n";
+
+    out += "template <typename CharT>\n"
+           "constexpr std::ptrdiff_t longestPrefix(const CharT* s, std::size_t n) noexcept {\n"
+           "    int state = kInitialState;\n"
+           "    std::ptrdiff_t last = kAccepting[state] ? 0 : -1;\n"
+           "    for (std::size_t i = 0; i < n; ++i) {\n"
+           "        state = kTransitions[state][classOf(codeUnit(s[i]))];\n"
+           "        if (state < 0) {\n"
+           "            break;\n"
+           "        }\n"
+           "        if (kAccepting[state]) {\n"
+           "            last = static_cast<std::ptrdiff_t>(i + 1);\n"
+           "        }\n"
+           "    }\n"
+           "    return last;\n"
+           "}\n\n";
+    return out;
+}
@@ -0,0 +1,35 @@
+#ifndef DFACODEGENERATOR_H
+#define DFACODEGENERATOR_H
+
+#include "./src/models/Automaton/Automaton.h"
+#include "CompiledDFA.h"
+#include <QString>
+#include <QVector>
+
+class DFACodeGenerator {
+public:
+    enum class Style {
+        DirectCoded,
+        TableDriven
+    };
+
+    DFACodeGenerator();
+
+    QString generate(const Automaton* automaton, Style style,
+                     const QString& namespaceName = QString(), QString* error = nullptr);
+
+    static QString sanitizeIdentifier(const QString& name);
+
+private:
+    CompiledDFA dfa;
+    QVector<int> order;
+    QVector<int> renumbered;
+
+    void collectReachableStates();
+    QString generateClassMap() const;
+    QString generateDirectCoded() const;
+    QString generateTableDriven() const;
+    static QString hex(uint value);
+};
+
+#endif
@@ -1,5 +1,6 @@
 #include "DFAMinimizer.h"
-#include <QQueue>
+#include "./src/models/Automaton/AutomatonBuilder.h"
+#include <QHash>
 #include <QDebug>
 #include <algorithm>
 
@@ -11,195 +12,124 @@ Automaton* DFAMinimizer::minimize(const Automaton* dfa) {
     }
 
      
-    Automaton* workingDFA = new Automaton(dfa->getId(), dfa->getName(), AutomatonType::DFA);
-
-     
-    for (const auto& state : dfa->getStates()) {
-        workingDFA->addState(state);
-    }
-
-     
-    for (const auto& trans : dfa->getTransitions()) {
-        workingDFA->addTransition(trans);
-    }
-
-     
-    for (const auto& symbol : dfa->getAlphabet()) {
-        workingDFA->addToAlphabet(symbol);
+    Automaton* workingDFA = copyReachable(dfa);
+    if (!workingDFA) {
+        return nullptr;
     }
 
-    workingDFA->setInitialState(dfa->getInitialStateId());
+    QSharedPointer<const AutomatonTopology> graph = workingDFA->getTopology();
 
      
-    removeUnreachableStates(workingDFA);
+    QVector<int> classOf = refinePartition(*graph);
 
      
-    QSet<QPair<QString, QString>> distinguishable = findDistinguishablePairs(workingDFA);
+    QVector<QVector<int>> equivalenceClasses = createEquivalenceClasses(*graph, classOf);
 
      
-    QVector<QSet<QString>> equivalenceClasses = createEquivalenceClasses(workingDFA, distinguishable);
-
-     
-    Automaton* minimizedDFA = buildMinimizedDFA(workingDFA, equivalenceClasses);
+    Automaton* minimizedDFA = buildMinimizedDFA(workingDFA, *graph, equivalenceClasses);
 
     delete workingDFA;
 
     return minimizedDFA;
 }
 
-void DFAMinimizer::removeUnreachableStates(Automaton* dfa) {
-    QSet<QString> reachable = getReachableStates(dfa);
+Automaton* DFAMinimizer::copyReachable(const Automaton* dfa) {
+    QSharedPointer<const AutomatonTopology> graph = dfa->getTopology();
+    QVector<bool> reachable = graph->reachableFrom(graph->getInitialState());
+
+    AutomatonBuilder builder(dfa->getId(), dfa->getName(), AutomatonType::DFA);
+    builder.reserve(graph->getStateCount(), dfa->getTransitionCount());
 
      
-    QVector<State> statesToRemove;
     for (const auto& state : dfa->getStates()) {
-        if (!reachable.contains(state.getId())) {
-            statesToRemove.push_back(state);
+        int index = graph->indexOf(state.getId());
+        if (reachable[index]) {
+            builder.addState(state);
         }
     }
 
-    for (const auto& state : statesToRemove) {
-        dfa->removeState(state.getId());
+    for (const auto& trans : dfa->getTransitions()) {
+        int index = graph->indexOf(trans.getFromStateId());
+        if (index != AutomatonTopology::NO_STATE && reachable[index]) {
+            builder.addTransition(trans);
+        }
     }
-}
 
-QSet<QString> DFAMinimizer::getReachableStates(const Automaton* dfa) {
-    QSet<QString> reachable;
-    QQueue<QString> queue;
-
-    QString initial = dfa->getInitialStateId();
-    if (initial.isEmpty()) {
-        return reachable;
+    for (const auto& symbol : dfa->getAlphabet()) {
+        builder.addToAlphabet(symbol);
     }
 
-    reachable.insert(initial);
-    queue.enqueue(initial);
+    return builder.finish();
+}
 
-    while (!queue.isEmpty()) {
-        QString current = queue.dequeue();
+QVector<int> DFAMinimizer::refinePartition(const AutomatonTopology& dfa) {
+    int stateCount = dfa.getStateCount();
+    int symbolCount = dfa.getSymbolCount();
+    int sink = stateCount;
 
-        for (const auto& trans : dfa->getTransitionsFrom(current)) {
-            QString next = trans.getToStateId();
-            if (!reachable.contains(next)) {
-                reachable.insert(next);
-                queue.enqueue(next);
-            }
+     
+    QVector<int> next((stateCount + 1) * symbolCount, sink);
+    for (int s = 0; s < stateCount; ++s) {
+        for (int e = dfa.edgeBegin(s); e < dfa.edgeEnd(s); ++e) {
+            next[s * symbolCount + dfa.edgeSymbol(e)] = dfa.edgeTarget(e);
         }
     }
 
-    return reachable;
-}
-
-QSet<QPair<QString, QString>> DFAMinimizer::findDistinguishablePairs(const Automaton* dfa) {
-    QSet<QPair<QString, QString>> distinguishable;
-    QVector<QString> stateIds;
-
-    for (const auto& state : dfa->getStates()) {
-        stateIds.push_back(state.getId());
+    QVector<int> classOf(stateCount + 1, 0);
+    int classCount = 1;
+    for (int s = 0; s < stateCount; ++s) {
+        if (dfa.isFinal(s)) {
+            classOf[s] = 1;
+            classCount = 2;
+        }
     }
 
      
-    for (int i = 0; i < stateIds.size(); i++) {
-        for (int j = i + 1; j < stateIds.size(); j++) {
-            const State* s1 = dfa->getState(stateIds[i]);
-            const State* s2 = dfa->getState(stateIds[j]);
+    QVector<int> signature(symbolCount);
+    while (true) {
+        QHash<QVector<int>, int> signatures;
+        QVector<int> refined(stateCount + 1);
+
+        for (int s = 0; s <= stateCount; ++s) {
+            signature[0] = classOf[s];
+            for (int a = 1; a < symbolCount; ++a) {
+                signature[a] = classOf[next[s * symbolCount + a]];
+            }
 
-            if (s1->getIsFinal() != s2->getIsFinal()) {
-                distinguishable.insert(makePair(stateIds[i], stateIds[j]));
+            int id = signatures.value(signature, -1);
+            if (id < 0) {
+                id = signatures.size();
+                signatures.insert(signature, id);
             }
+            refined[s] = id;
         }
-    }
 
-     
-    bool changed = true;
-    while (changed) {
-        changed = false;
-
-        for (int i = 0; i < stateIds.size(); i++) {
-            for (int j = i + 1; j < stateIds.size(); j++) {
-                QString s1 = stateIds[i];
-                QString s2 = stateIds[j];
-
-                auto pair = makePair(s1, s2);
-
-                if (distinguishable.contains(pair)) {
-                    continue;  
-                }
-
-                 
-                for (const auto& symbol : dfa->getAlphabet()) {
-                    QString next1, next2;
-
-                     
-                    for (const auto& trans : dfa->getTransitionsFrom(s1)) {
-                        if (trans.hasSymbol(symbol)) {
-                            next1 = trans.getToStateId();
-                            break;
-                        }
-                    }
-
-                     
-                    for (const auto& trans : dfa->getTransitionsFrom(s2)) {
-                        if (trans.hasSymbol(symbol)) {
-                            next2 = trans.getToStateId();
-                            break;
-                        }
-                    }
-
-                     
-                    if (!next1.isEmpty() && !next2.isEmpty() && next1 != next2) {
-                        auto nextPair = makePair(next1, next2);
-                        if (distinguishable.contains(nextPair)) {
-                            distinguishable.insert(pair);
-                            changed = true;
-                            break;
-                        }
-                    }
-                }
-            }
+        bool stable = signatures.size() == classCount;
+        classOf = refined;
+        classCount = signatures.size();
+        if (stable) {
+            break;
         }
     }
 
-    return distinguishable;
+    return classOf;
 }
 
-QVector<QSet<QString>> DFAMinimizer::createEquivalenceClasses(
-    const Automaton* dfa,
-    const QSet<QPair<QString, QString>>& distinguishable) {
-
-    QVector<QSet<QString>> classes;
-    QSet<QString> processed;
-
-    for (const auto& state : dfa->getStates()) {
-        QString stateId = state.getId();
-
-        if (processed.contains(stateId)) {
-            continue;
-        }
-
-         
-        QSet<QString> equivalenceClass;
-        equivalenceClass.insert(stateId);
-        processed.insert(stateId);
+QVector<QVector<int>> DFAMinimizer::createEquivalenceClasses(
+    const AutomatonTopology& dfa,
+    const QVector<int>& classOf) {
 
-         
-        for (const auto& other : dfa->getStates()) {
-            QString otherId = other.getId();
-
-            if (processed.contains(otherId) || stateId == otherId) {
-                continue;
-            }
+    QVector<QVector<int>> classes;
+    QHash<int, int> order;
 
-             
-            auto pair = makePair(stateId, otherId);
-            if (!distinguishable.contains(pair)) {
-                 
-                equivalenceClass.insert(otherId);
-                processed.insert(otherId);
-            }
+    for (int s = 0; s < dfa.getStateCount(); ++s) {
+        int index = order.value(classOf[s], -1);
+        if (index < 0) {
+            index = classes.size();
+            order.insert(classOf[s], index);
+            classes.append(QVector<int>());
         }
-
-        classes.push_back(equivalenceClass);
+        classes[index].append(s);
     }
 
     return classes;
@@ -207,101 +137,67 @@ QVector<QSet<QString>> DFAMinimizer::createEquivalenceClasses(
 
 Automaton* DFAMinimizer::buildMinimizedDFA(
     const Automaton* dfa,
-    const QVector<QSet<QString>>& equivalenceClasses) {
+    const AutomatonTopology& graph,
+    const QVector<QVector<int>>& equivalenceClasses) {
 
-    Automaton* minimized = new Automaton("", dfa->getName() + " (Minimized)", AutomatonType::DFA);
+    AutomatonBuilder minimized("", dfa->getName() + " (Minimized)", AutomatonType::DFA);
+    minimized.reserve(equivalenceClasses.size(), dfa->getTransitionCount());
 
      
     for (const auto& symbol : dfa->getAlphabet()) {
-        minimized->addToAlphabet(symbol);
+        minimized.addToAlphabet(symbol);
     }
 
      
-    QMap<int, QString> classToStateId;
+    QVector<QString> classToStateId(equivalenceClasses.size());
+    QVector<int> classOfState(graph.getStateCount(), -1);
 
     for (int i = 0; i < equivalenceClasses.size(); i++) {
-        const QSet<QString>& eqClass = equivalenceClasses[i];
+        const QVector<int>& eqClass = equivalenceClasses[i];
 
          
-        QStringList sorted = eqClass.values();
+        QStringList sorted;
+        bool isInitial = false;
+        bool isFinal = false;
+        for (int state : eqClass) {
+            sorted.append(graph.getStateId(state));
+            isInitial = isInitial || state == graph.getInitialState();
+            isFinal = isFinal || graph.isFinal(state);
+            classOfState[state] = i;
+        }
         sorted.sort();
-        QString representative = sorted.first();
 
          
         QString newStateId;
         if (eqClass.size() == 1) {
-            newStateId = representative;
+            newStateId = sorted.first();
         } else {
             newStateId = "{" + sorted.join(",") + "}";
         }
-
         classToStateId[i] = newStateId;
 
-         
-        bool isInitial = eqClass.contains(dfa->getInitialStateId());
-        bool isFinal = false;
-
-        for (const auto& stateId : eqClass) {
-            const State* state = dfa->getState(stateId);
-            if (state && state->getIsFinal()) {
-                isFinal = true;
-                break;
-            }
-        }
-
         State newState(newStateId, newStateId, QPointF(0, 0));
         newState.setIsInitial(isInitial);
         newState.setIsFinal(isFinal);
-        minimized->addState(newState);
-
-        if (isInitial) {
-            minimized->setInitialState(newStateId);
-        }
+        minimized.addState(newState);
     }
 
      
     for (int i = 0; i < equivalenceClasses.size(); i++) {
-        const QSet<QString>& eqClass = equivalenceClasses[i];
-        QString fromStateId = classToStateId[i];
+        int representative = equivalenceClasses[i].first();
 
          
-        QString representative = eqClass.values().first();
-
-         
-        for (const auto& symbol : dfa->getAlphabet()) {
-            for (const auto& trans : dfa->getTransitionsFrom(representative)) {
-                if (trans.hasSymbol(symbol)) {
-                     
-                    int targetClass = findClassIndex(equivalenceClasses, trans.getToStateId());
-                    if (targetClass >= 0) {
-                        QString toStateId = classToStateId[targetClass];
-
-                        Transition newTrans(fromStateId, toStateId, symbol);
-                        minimized->addTransition(newTrans);
-                    }
-                    break;  
-                }
+        QHash<int, QSet<QString>> symbolsByTarget;
+        for (int e = graph.edgeBegin(representative); e < graph.edgeEnd(representative); ++e) {
+            if (graph.edgeSymbol(e) != AutomatonTopology::EPSILON) {
+                symbolsByTarget[classOfState[graph.edgeTarget(e)]].insert(graph.getSymbol(graph.edgeSymbol(e)));
             }
         }
-    }
-
-    return minimized;
-}
 
-int DFAMinimizer::findClassIndex(const QVector<QSet<QString>>& classes, const QString& stateId) {
-    for (int i = 0; i < classes.size(); i++) {
-        if (classes[i].contains(stateId)) {
-            return i;
+        for (auto it = symbolsByTarget.constBegin(); it != symbolsByTarget.constEnd(); ++it) {
+            minimized.addTransition(Transition(classToStateId[i], classToStateId[it.key()], it.value()));
         }
     }
-    return -1;
-}
 
-QPair<QString, QString> DFAMinimizer::makePair(const QString& s1, const QString& s2) {
-     
-    if (s1 < s2) {
-        return qMakePair(s1, s2);
-    } else {
-        return qMakePair(s2, s1);
-    }
+    return minimized.finish();
 }
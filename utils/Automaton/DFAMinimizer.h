@@ -16,31 +16,23 @@ public:
 
 private:
      
-    void removeUnreachableStates(Automaton* dfa);
+    Automaton* copyReachable(const Automaton* dfa);
 
      
-    QSet<QString> getReachableStates(const Automaton* dfa);
+    QVector<int> refinePartition(const AutomatonTopology& dfa);
 
      
-    QSet<QPair<QString, QString>> findDistinguishablePairs(const Automaton* dfa);
-
-     
-    QVector<QSet<QString>> createEquivalenceClasses(
-        const Automaton* dfa,
-        const QSet<QPair<QString, QString>>& distinguishable
+    QVector<QVector<int>> createEquivalenceClasses(
+        const AutomatonTopology& dfa,
+        const QVector<int>& classOf
         );
 
      
     Automaton* buildMinimizedDFA(
         const Automaton* dfa,
-        const QVector<QSet<QString>>& equivalenceClasses
+        const AutomatonTopology& graph,
+        const QVector<QVector<int>>& equivalenceClasses
         );
-
-     
-    int findClassIndex(const QVector<QSet<QString>>& classes, const QString& stateId);
-
-     
-    QPair<QString, QString> makePair(const QString& s1, const QString& s2);
 };
 
 #endif  
@@ -0,0 +1,270 @@
+#include "MappedDFA.h"
+#include <cstring>
+
+MappedDFA::MappedDFA() {
+    detach();
+}
+
+void MappedDFA::detach() {
+    data = nullptr;
+    classMap = nullptr;
+    wideMap = nullptr;
+    table = nullptr;
+    accept = nullptr;
+    layout = nullptr;
+    labels = nullptr;
+    pool = nullptr;
+    stateCount = 0;
+    classCount = 0;
+    wideCount = 0;
+    initialState = -1;
+}
+
+bool MappedDFA::attach(const uchar* bytes, qint64 size, QString* error) {
+    typedef AutomatonBinaryLayout L;
+    detach();
+
+    auto fail = [error](const QString& message) {
+        if (error) *error = message;
+        return false;
+    };
+    auto read16 = [bytes](qint64 offset) { return qFromLittleEndian<quint16>(bytes + offset); };
+    auto read32 = [bytes](qint64 offset) { return qFromLittleEndian<quint32>(bytes + offset); };
+
+    if (!bytes || size < L::HEADER_SIZE) {
+        return fail("File is too small to be a compiled automaton.");
+    }
+    if (read32(L::Magic) != L::MAGIC) {
+        return fail("Not a compiled automaton file.");
+    }
+    if (read16(L::Version) != L::VERSION) {
+        return fail(QString("Unsupported format version %1.").arg(read16(L::Version)));
+    }
+
+    quint64 fileSize = read32(L::FileSize);
+    quint32 headerSize = read32(L::HeaderSize);
+    if (fileSize > quint64(size) || headerSize < quint32(L::HEADER_SIZE) || headerSize > fileSize) {
+        return fail("File is truncated.");
+    }
+
+    quint64 states = read32(L::StateCount);
+    quint64 classes = read32(L::ClassCount);
+    quint64 wide = read32(L::WideCount);
+    quint32 initial = read32(L::InitialState);
+    quint16 flags = read16(L::Flags);
+    if (states == 0 || classes == 0 || classes > 65536 || wide > 65536 || initial >= states) {
+        return fail("File header is corrupt.");
+    }
+
+    auto fits = [headerSize, fileSize](quint64 offset, quint64 length) {
+        return offset >= headerSize && offset % 4 == 0 && offset + length <= fileSize;
+    };
+
+    quint32 classMapOffset = read32(L::ClassMapOffset);
+    quint32 wideMapOffset = read32(L::WideMapOffset);
+    quint32 tableOffset = read32(L::TableOffset);
+    quint32 acceptOffset = read32(L::AcceptOffset);
+    quint32 layoutOffset = read32(L::LayoutOffset);
+    quint32 labelsOffset = read32(L::LabelsOffset);
+
+    if (!fits(classMapOffset, 256 * 2) || !fits(wideMapOffset, wide * 4) ||
+        !fits(tableOffset, states * classes * 4) || !fits(acceptOffset, states) ||
+        ((flags & L::HAS_LAYOUT) && !fits(layoutOffset, states * 16)) ||
+        ((flags & L::HAS_LABELS) && !fits(labelsOffset, 8))) {
+        return fail("File sections are out of bounds.");
+    }
+
+
+    for (int u = 0; u < 256; ++u) {
+        if (read16(classMapOffset + 2 * u) >= classes) {
+            return fail("Symbol class map is corrupt.");
+        }
+    }
+    for (quint64 i = 0; i < wide; ++i) {
+        quint16 symbol = read16(wideMapOffset + 4 * i);
+        if (symbol < 256 || read16(wideMapOffset + 4 * i + 2) >= classes ||
+            (i > 0 && symbol <= read16(wideMapOffset + 4 * (i - 1)))) {
+            return fail("Symbol class map is corrupt.");
+        }
+    }
+    for (quint64 i = 0; i < states * classes; ++i) {
+        qint32 target = qFromLittleEndian<qint32>(bytes + tableOffset + 4 * i);
+        if (target < DEAD_STATE || target >= qint64(states)) {
+            return fail("Transition table is corrupt.");
+        }
+    }
+
+    if (flags & L::HAS_LABELS) {
+        quint64 count = read32(labelsOffset);
+        quint64 poolUnits = read32(labelsOffset + 4);
+        quint64 poolOffset = labelsOffset + 8 + count * 8;
+        if (count != 1 + 2 * states || !fits(labelsOffset, 8 + count * 8 + poolUnits * 2)) {
+            return fail("Label section is corrupt.");
+        }
+        for (quint64 i = 0; i < count; ++i) {
+            quint64 start = read32(labelsOffset + 8 + 8 * i);
+            quint64 length = read32(labelsOffset + 12 + 8 * i);
+            if (start + length > poolUnits) {
+                return fail("Label section is corrupt.");
+            }
+        }
+        labels = bytes + labelsOffset;
+        pool = bytes + poolOffset;
+    }
+
+
+    data = bytes;
+    classMap = bytes + classMapOffset;
+    wideMap = bytes + wideMapOffset;
+    table = bytes + tableOffset;
+    accept = bytes + acceptOffset;
+    layout = (flags & L::HAS_LAYOUT) ? bytes + layoutOffset : nullptr;
+    stateCount = int(states);
+    classCount = int(classes);
+    wideCount = int(wide);
+    initialState = int(initial);
+    return true;
+}
+
+int MappedDFA::wideClassOf(ushort u) const {
+    int low = 0;
+    int high = wideCount - 1;
+    while (low <= high) {
+        int mid = (low + high) / 2;
+        ushort symbol = qFromLittleEndian<quint16>(wideMap + 4 * mid);
+        if (symbol == u) {
+            return qFromLittleEndian<quint16>(wideMap + 4 * mid + 2);
+        }
+        if (symbol < u) {
+            low = mid + 1;
+        } else {
+            high = mid - 1;
+        }
+    }
+    return 0;
+}
+
+bool MappedDFA::accepts(const QString& input) const {
+    if (!isValid()) {
+        return false;
+    }
+
+    int state = initialState;
+    for (QChar c : input) {
+        state = next(state, c);
+        if (state == DEAD_STATE) {
+            return false;
+        }
+    }
+    return isAccepting(state);
+}
+
+int MappedDFA::longestPrefix(const QString& text, int from) const {
+    if (!isValid() || from < 0 || from > text.length()) {
+        return -1;
+    }
+
+    const QChar* chars = text.constData();
+    int length = text.length();
+    int state = initialState;
+    int last = isAccepting(state) ? 0 : -1;
+
+    for (int i = from; i < length; ++i) {
+        state = next(state, chars[i]);
+        if (state == DEAD_STATE) {
+            break;
+        }
+        if (isAccepting(state)) {
+            last = i + 1 - from;
+        }
+    }
+    return last;
+}
+
+QVector<QChar> MappedDFA::getClassMembers(int symbolClass) const {
+    QVector<QChar> members;
+    if (!isValid() || symbolClass <= 0) {
+        return members;
+    }
+
+    for (int u = 0; u < 256; ++u) {
+        if (qFromLittleEndian<quint16>(classMap + 2 * u) == symbolClass) {
+            members.append(QChar(ushort(u)));
+        }
+    }
+    for (int i = 0; i < wideCount; ++i) {
+        if (qFromLittleEndian<quint16>(wideMap + 4 * i + 2) == symbolClass) {
+            members.append(QChar(qFromLittleEndian<quint16>(wideMap + 4 * i)));
+        }
+    }
+    return members;
+}
+
+QPointF MappedDFA::getStatePosition(int state) const {
+    if (!layout || state < 0 || state >= stateCount) {
+        return QPointF();
+    }
+
+    quint64 x = qFromLittleEndian<quint64>(layout + 16 * state);
+    quint64 y = qFromLittleEndian<quint64>(layout + 16 * state + 8);
+    double px, py;
+    std::memcpy(&px, &x, sizeof(double));
+    std::memcpy(&py, &y, sizeof(double));
+    return QPointF(px, py);
+}
+
+QString MappedDFA::getString(int index) const {
+    if (!labels || index < 0 || index > 2 * stateCount) {
+        return QString();
+    }
+
+    quint32 start = qFromLittleEndian<quint32>(labels + 8 + 8 * index);
+    quint32 length = qFromLittleEndian<quint32>(labels + 12 + 8 * index);
+    QString result;
+    result.reserve(int(length));
+    for (quint32 i = 0; i < length; ++i) {
+        result += QChar(qFromLittleEndian<quint16>(pool + 2 * (start + i)));
+    }
+    return result;
+}
+
+
+MappedAutomatonFile::MappedAutomatonFile() : mapped(nullptr) {}
+
+MappedAutomatonFile::~MappedAutomatonFile() {
+    close();
+}
+
+bool MappedAutomatonFile::open(const QString& fileName, QString* error) {
+    close();
+
+    file.setFileName(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) *error = QString("Could not open %1: %2").arg(fileName).arg(file.errorString());
+        return false;
+    }
+
+    mapped = file.map(0, file.size());
+    if (!mapped) {
+        if (error) *error = QString("Could not map %1: %2").arg(fileName).arg(file.errorString());
+        close();
+        return false;
+    }
+
+    if (!dfa.attach(mapped, file.size(), error)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void MappedAutomatonFile::close() {
+    dfa.detach();
+    if (mapped) {
+        file.unmap(mapped);
+        mapped = nullptr;
+    }
+    if (file.isOpen()) {
+        file.close();
+    }
+}
@@ -0,0 +1,118 @@
+#ifndef MAPPEDDFA_H
+#define MAPPEDDFA_H
+
+#include <QString>
+#include <QVector>
+#include <QChar>
+#include <QPointF>
+#include <QFile>
+#include <QtEndian>
+
+
+struct AutomatonBinaryLayout {
+    static constexpr quint32 MAGIC = 0x44545541;
+    static constexpr quint16 VERSION = 1;
+    static constexpr quint16 HAS_LAYOUT = 0x1;
+    static constexpr quint16 HAS_LABELS = 0x2;
+    static constexpr int HEADER_SIZE = 64;
+
+    enum Field {
+        Magic = 0,
+        Version = 4,
+        Flags = 6,
+        HeaderSize = 8,
+        StateCount = 12,
+        ClassCount = 16,
+        InitialState = 20,
+        WideCount = 24,
+        ClassMapOffset = 32,
+        WideMapOffset = 36,
+        TableOffset = 40,
+        AcceptOffset = 44,
+        LayoutOffset = 48,
+        LabelsOffset = 52,
+        FileSize = 56
+    };
+};
+
+
+class MappedDFA {
+public:
+    static constexpr int DEAD_STATE = -1;
+
+    MappedDFA();
+
+    bool attach(const uchar* bytes, qint64 size, QString* error = nullptr);
+    void detach();
+    bool isValid() const { return data != nullptr; }
+
+    int getInitialState() const { return initialState; }
+    int getStateCount() const { return stateCount; }
+    int getClassCount() const { return classCount; }
+    bool hasLayout() const { return layout != nullptr; }
+    bool hasLabels() const { return labels != nullptr; }
+
+    int classOf(QChar c) const {
+        ushort u = c.unicode();
+        return u < 256 ? qFromLittleEndian<quint16>(classMap + 2 * u) : wideClassOf(u);
+    }
+
+    int nextByClass(int state, int symbolClass) const {
+        return qFromLittleEndian<qint32>(table + 4 * (qint64(state) * classCount + symbolClass));
+    }
+
+    int next(int state, QChar c) const {
+        return nextByClass(state, classOf(c));
+    }
+
+    bool isAccepting(int state) const { return state >= 0 && accept[state] != 0; }
+
+    bool accepts(const QString& input) const;
+    int longestPrefix(const QString& text, int from = 0) const;
+
+
+    QVector<QChar> getClassMembers(int symbolClass) const;
+    QPointF getStatePosition(int state) const;
+    QString getName() const { return getString(0); }
+    QString getStateId(int state) const { return getString(1 + 2 * state); }
+    QString getStateLabel(int state) const { return getString(2 + 2 * state); }
+
+private:
+    const uchar* data;
+    const uchar* classMap;
+    const uchar* wideMap;
+    const uchar* table;
+    const uchar* accept;
+    const uchar* layout;
+    const uchar* labels;
+    const uchar* pool;
+    int stateCount;
+    int classCount;
+    int wideCount;
+    int initialState;
+
+    int wideClassOf(ushort u) const;
+    QString getString(int index) const;
+};
+
+
+class MappedAutomatonFile {
+public:
+    MappedAutomatonFile();
+    ~MappedAutomatonFile();
+
+    bool open(const QString& fileName, QString* error = nullptr);
+    void close();
+
+    const MappedDFA& getDFA() const { return dfa; }
+
+private:
+    QFile file;
+    uchar* mapped;
+    MappedDFA dfa;
+
+    MappedAutomatonFile(const MappedAutomatonFile&) = delete;
+    MappedAutomatonFile& operator=(const MappedAutomatonFile&) = delete;
+};
+
+#endif
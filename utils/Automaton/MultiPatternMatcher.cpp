@@ -0,0 +1,620 @@
+#include "MultiPatternMatcher.h"
+#include "RegexCache.h"
+#include "ScanKernels.h"
+#include <QMap>
+#include <QQueue>
+#include <algorithm>
+
+MultiPatternMatcher::MultiPatternMatcher()
+    : patternCount(0), compiled(false), literalSet(false) {}
+
+void MultiPatternMatcher::clear() {
+    patternCount = 0;
+    compiled = false;
+    literalSet = false;
+    epsilonEdges.clear();
+    symbolEdges.clear();
+    acceptPattern.clear();
+    patternStarts.clear();
+    literals.clear();
+    literalIds.clear();
+    acGoto.clear();
+    acFail.clear();
+    acDepth.clear();
+    acLongestPattern.clear();
+    acLongestLength.clear();
+    dfa.clear();
+    acceptSets.clear();
+    startClasses.clear();
+}
+
+int MultiPatternMatcher::addNFAState() {
+    epsilonEdges.append(QVector<int>());
+    symbolEdges.append(QVector<QPair<ushort, int>>());
+    acceptPattern.append(-1);
+    return acceptPattern.size() - 1;
+}
+
+bool MultiPatternMatcher::isLiteralRegex(const QString& regex) const {
+    if (regex.isEmpty()) {
+        return false;
+    }
+
+    for (QChar c : regex) {
+        if (c == '|' || c == '*' || c == '+' || c == '?' || c == '.' ||
+            c == '(' || c == ')' || c == '{' || c == 'E' || c == QChar(0x03B5)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int MultiPatternMatcher::addPattern(const QString& regex) {
+    QSharedPointer<const Automaton> nfa = RegexCache::instance().get(regex, RegexStage::NFA);
+    if (nfa.isNull()) {
+        return -1;
+    }
+
+    int id = addAutomaton(nfa.data());
+
+    if (isLiteralRegex(regex)) {
+        literals[id] = regex;
+    }
+    return id;
+}
+
+int MultiPatternMatcher::addAutomaton(const Automaton* automaton) {
+    int id = patternCount++;
+    compiled = false;
+    literals.append(QString());
+
+    if (!automaton || !automaton->isValid()) {
+        patternStarts.append(-1);
+        return id;
+    }
+
+    QHash<QString, int> stateIndex;
+    for (const auto& state : automaton->getStates()) {
+        int s = addNFAState();
+        stateIndex.insert(state.getId(), s);
+        if (state.getIsFinal()) {
+            acceptPattern[s] = id;
+        }
+    }
+
+    for (const auto& t : automaton->getTransitions()) {
+        int from = stateIndex.value(t.getFromStateId(), -1);
+        int to = stateIndex.value(t.getToStateId(), -1);
+        if (from < 0 || to < 0) {
+            continue;
+        }
+
+        for (const auto& sym : t.getSymbols()) {
+            if (sym == "E" || sym == "ε" || sym == "epsilon" || sym.isEmpty()) {
+                epsilonEdges[from].append(to);
+            } else if (sym.length() == 1) {
+                symbolEdges[from].append(qMakePair(sym[0].unicode(), to));
+            }
+        }
+    }
+
+    patternStarts.append(stateIndex.value(automaton->getInitialStateId(), -1));
+    return id;
+}
+
+int MultiPatternMatcher::addLiteral(const QString& literal) {
+    int id = patternCount++;
+    compiled = false;
+    literals.append(literal);
+
+    if (literal.isEmpty()) {
+        patternStarts.append(-1);
+        return id;
+    }
+
+    int state = addNFAState();
+    patternStarts.append(state);
+    for (QChar c : literal) {
+        int next = addNFAState();
+        symbolEdges[state].append(qMakePair(c.unicode(), next));
+        state = next;
+    }
+    acceptPattern[state] = id;
+    return id;
+}
+
+bool MultiPatternMatcher::compile() {
+    compiled = false;
+
+    literalSet = patternCount > 0;
+    for (const auto& literal : literals) {
+        if (literal.isEmpty()) {
+            literalSet = false;
+            break;
+        }
+    }
+
+    literalIds.clear();
+    if (literalSet) {
+        for (int i = 0; i < literals.size(); ++i) {
+            literalIds[literals[i]].append(i);
+        }
+        buildAhoCorasick();
+    }
+
+    if (!buildUnionDFA()) {
+        return false;
+    }
+
+    int initial = dfa.getInitialState();
+    startClasses.fill(false, dfa.getClassCount());
+    for (int c = 1; c < dfa.getClassCount(); ++c) {
+        startClasses[c] = dfa.nextByClass(initial, c) != CompiledDFA::DEAD_STATE;
+    }
+    findRunStates();
+
+    compiled = true;
+    return true;
+}
+
+void MultiPatternMatcher::findRunStates() {
+    static const char digits[] = "0123456789";
+    static const char identifier[] = "0123456789_ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+
+    auto loopsOn = [this](int state, const char* run) {
+        for (; *run; ++run) {
+            if (dfa.next(state, QLatin1Char(*run)) != state) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    runStates.fill(NoRun, dfa.getStateCount());
+    for (int s = 0; s < dfa.getStateCount(); ++s) {
+        if (loopsOn(s, identifier)) {
+            runStates[s] = IdentifierRun;
+        } else if (loopsOn(s, digits)) {
+            runStates[s] = DigitRun;
+        }
+    }
+}
+
+void MultiPatternMatcher::closure(QVector<int>& states, QVector<int>& marks, int stamp) const {
+    QVector<int> stack;
+    for (int s : states) {
+        if (marks[s] != stamp) {
+            marks[s] = stamp;
+            stack.append(s);
+        }
+    }
+
+    states.clear();
+    while (!stack.isEmpty()) {
+        int s = stack.takeLast();
+        states.append(s);
+        for (int t : epsilonEdges[s]) {
+            if (marks[t] != stamp) {
+                marks[t] = stamp;
+                stack.append(t);
+            }
+        }
+    }
+
+    std::sort(states.begin(), states.end());
+}
+
+bool MultiPatternMatcher::buildUnionDFA() {
+    acceptSets.clear();
+
+    QVector<int> marks(acceptPattern.size(), 0);
+    int stamp = 0;
+
+    QVector<int> start;
+    for (int s : patternStarts) {
+        if (s >= 0) {
+            start.append(s);
+        }
+    }
+    closure(start, marks, ++stamp);
+
+    QHash<QVector<int>, int> setIndex;
+    QVector<QVector<int>> sets;
+    QVector<QVector<QPair<ushort, int>>> dfaEdges;
+    setIndex.insert(start, 0);
+    sets.append(start);
+
+    for (int d = 0; d < sets.size(); ++d) {
+        QVector<int> current = sets[d];
+        QMap<ushort, QVector<int>> moves;
+        QVector<int> accepts;
+
+        for (int s : current) {
+            if (acceptPattern[s] >= 0) {
+                accepts.append(acceptPattern[s]);
+            }
+            for (const auto& edge : symbolEdges[s]) {
+                moves[edge.first].append(edge.second);
+            }
+        }
+
+        std::sort(accepts.begin(), accepts.end());
+        accepts.erase(std::unique(accepts.begin(), accepts.end()), accepts.end());
+        acceptSets.append(accepts);
+
+        QVector<QPair<ushort, int>> edges;
+        for (auto it = moves.begin(); it != moves.end(); ++it) {
+            QVector<int> targets = it.value();
+            closure(targets, marks, ++stamp);
+
+            int next = setIndex.value(targets, -1);
+            if (next < 0) {
+                next = sets.size();
+                setIndex.insert(targets, next);
+                sets.append(targets);
+            }
+            edges.append(qMakePair(it.key(), next));
+        }
+        dfaEdges.append(edges);
+    }
+    minimizeUnionDFA(dfaEdges);
+
+
+    int count = dfaEdges.size();
+    QHash<ushort, QVector<qint32>> columns;
+    QVector<bool> accepting(count, false);
+
+    for (int d = 0; d < count; ++d) {
+        accepting[d] = !acceptSets[d].isEmpty();
+        for (const auto& edge : dfaEdges[d]) {
+            QVector<qint32>& column = columns[edge.first];
+            if (column.isEmpty()) {
+                column.fill(CompiledDFA::DEAD_STATE, count);
+            }
+            column[d] = edge.second;
+        }
+    }
+
+    return dfa.compileFromColumns(0, accepting, columns);
+}
+
+void MultiPatternMatcher::minimizeUnionDFA(QVector<QVector<QPair<ushort, int>>>& dfaEdges) {
+    int count = dfaEdges.size();
+    QVector<int> classOf(count);
+    QHash<QVector<int>, int> classIndex;
+    for (int d = 0; d < count; ++d) {
+        auto it = classIndex.find(acceptSets[d]);
+        if (it == classIndex.end()) {
+            it = classIndex.insert(acceptSets[d], classIndex.size());
+        }
+        classOf[d] = it.value();
+    }
+
+    int classCount = classIndex.size();
+    while (true) {
+        QHash<QVector<int>, int> signatures;
+        QVector<int> refined(count);
+        for (int d = 0; d < count; ++d) {
+            QVector<int> signature;
+            signature.reserve(1 + 2 * dfaEdges[d].size());
+            signature.append(classOf[d]);
+            for (const auto& edge : dfaEdges[d]) {
+                signature.append(edge.first);
+                signature.append(classOf[edge.second]);
+            }
+
+            auto it = signatures.find(signature);
+            if (it == signatures.end()) {
+                it = signatures.insert(signature, signatures.size());
+            }
+            refined[d] = it.value();
+        }
+
+        classOf = refined;
+        if (signatures.size() == classCount) {
+            break;
+        }
+        classCount = signatures.size();
+    }
+
+    if (classCount == count) {
+        return;
+    }
+
+    QVector<QVector<QPair<ushort, int>>> mergedEdges(classCount);
+    QVector<QVector<int>> mergedAccepts(classCount);
+    QVector<bool> done(classCount, false);
+    for (int d = 0; d < count; ++d) {
+        int c = classOf[d];
+        if (done[c]) {
+            continue;
+        }
+        done[c] = true;
+        mergedAccepts[c] = acceptSets[d];
+        for (const auto& edge : dfaEdges[d]) {
+            mergedEdges[c].append(qMakePair(edge.first, classOf[edge.second]));
+        }
+    }
+
+    dfaEdges = mergedEdges;
+    acceptSets = mergedAccepts;
+}
+
+void MultiPatternMatcher::buildAhoCorasick() {
+    acGoto = QVector<QHash<ushort, int>>(1);
+    acFail = QVector<int>(1, 0);
+    acDepth = QVector<int>(1, 0);
+    acLongestPattern = QVector<int>(1, -1);
+    acLongestLength = QVector<int>(1, 0);
+
+    for (int id = 0; id < literals.size(); ++id) {
+        int node = 0;
+        for (QChar c : literals[id]) {
+            int next = acGoto[node].value(c.unicode(), -1);
+            if (next < 0) {
+                next = acGoto.size();
+                acGoto.append(QHash<ushort, int>());
+                acFail.append(0);
+                acDepth.append(acDepth[node] + 1);
+                acLongestPattern.append(-1);
+                acLongestLength.append(0);
+                acGoto[node].insert(c.unicode(), next);
+            }
+            node = next;
+        }
+
+        if (acLongestPattern[node] < 0) {
+            acLongestPattern[node] = id;
+            acLongestLength[node] = literals[id].length();
+        }
+    }
+
+
+    QQueue<int> queue;
+    for (auto it = acGoto[0].constBegin(); it != acGoto[0].constEnd(); ++it) {
+        queue.enqueue(it.value());
+    }
+
+    while (!queue.isEmpty()) {
+        int node = queue.dequeue();
+
+        for (auto it = acGoto[node].constBegin(); it != acGoto[node].constEnd(); ++it) {
+            ushort u = it.key();
+            int child = it.value();
+
+            int fail = acFail[node];
+            while (fail > 0 && !acGoto[fail].contains(u)) {
+                fail = acFail[fail];
+            }
+            int target = (node == 0) ? 0 : acGoto[fail].value(u, 0);
+
+            acFail[child] = target;
+            if (acLongestPattern[child] < 0) {
+                acLongestPattern[child] = acLongestPattern[target];
+                acLongestLength[child] = acLongestLength[target];
+            }
+            queue.enqueue(child);
+        }
+    }
+}
+
+int MultiPatternMatcher::match(const QString& input) const {
+    QVector<int> ids = matchAll(input);
+    return ids.isEmpty() ? -1 : ids.first();
+}
+
+QVector<int> MultiPatternMatcher::matchAll(const QString& input) const {
+    if (!compiled) {
+        return QVector<int>();
+    }
+
+    if (literalSet) {
+        return literalIds.value(input);
+    }
+
+    int state = dfa.getInitialState();
+    for (QChar c : input) {
+        state = dfa.next(state, c);
+        if (state == CompiledDFA::DEAD_STATE) {
+            return QVector<int>();
+        }
+    }
+    return acceptSets[state];
+}
+
+PatternMatch MultiPatternMatcher::longestMatchAt(const QString& text, int pos) const {
+    if (!compiled || pos < 0 || pos > text.length()) {
+        return PatternMatch();
+    }
+
+    const QChar* data = text.constData();
+    int length = text.length();
+    int state = dfa.getInitialState();
+    int lastEnd = -1;
+    int lastState = -1;
+
+    if (dfa.isAccepting(state)) {
+        lastEnd = pos;
+        lastState = state;
+    }
+
+    for (int i = pos; i < length; ++i) {
+        int next = dfa.next(state, data[i]);
+        if (next == state && runStates[state] != NoRun) {
+            i = (runStates[state] == IdentifierRun ? ScanKernels::identifierEnd(data, i + 1, length)
+                                                  : ScanKernels::digitsEnd(data, i + 1, length)) - 1;
+        }
+        state = next;
+        if (state == CompiledDFA::DEAD_STATE) {
+            break;
+        }
+        if (dfa.isAccepting(state)) {
+            lastEnd = i + 1;
+            lastState = state;
+        }
+    }
+
+    if (lastState < 0) {
+        return PatternMatch();
+    }
+    return PatternMatch(pos, lastEnd - pos, acceptSets[lastState].first());
+}
+
+PatternMatch MultiPatternMatcher::longestMatchAt(const char* utf8, int size, int pos) const {
+    if (!compiled || pos < 0 || pos > size) {
+        return PatternMatch();
+    }
+
+    const uchar* data = reinterpret_cast<const uchar*>(utf8);
+    int state = dfa.getInitialState();
+    int lastEnd = -1;
+    int lastState = -1;
+
+    if (dfa.isAccepting(state)) {
+        lastEnd = pos;
+        lastState = state;
+    }
+
+    int i = pos;
+    while (i < size) {
+        uint c = data[i];
+        if (c < 0x80) {
+            int next = dfa.next(state, QChar(ushort(c)));
+            if (next == state && runStates[state] != NoRun) {
+                i = runStates[state] == IdentifierRun ? ScanKernels::identifierEnd(utf8, i + 1, size)
+                                                      : ScanKernels::digitsEnd(utf8, i + 1, size);
+            } else {
+                i++;
+            }
+            state = next;
+        } else {
+            i += decodeUtf8(data + i, size - i, c);
+            if (c > 0xffff) {
+                state = dfa.next(state, QChar(QChar::highSurrogate(c)));
+                if (state == CompiledDFA::DEAD_STATE) {
+                    break;
+                }
+                state = dfa.next(state, QChar(QChar::lowSurrogate(c)));
+            } else {
+                state = dfa.next(state, QChar(ushort(c)));
+            }
+        }
+
+        if (state == CompiledDFA::DEAD_STATE) {
+            break;
+        }
+        if (dfa.isAccepting(state)) {
+            lastEnd = i;
+            lastState = state;
+        }
+    }
+
+    if (lastState < 0) {
+        return PatternMatch();
+    }
+    return PatternMatch(pos, lastEnd - pos, acceptSets[lastState].first());
+}
+
+int MultiPatternMatcher::decodeUtf8(const uchar* bytes, int available, uint& codePoint) {
+    uchar lead = bytes[0];
+    int length = lead >= 0xf0 ? 4 : lead >= 0xe0 ? 3 : lead >= 0xc2 ? 2 : 1;
+    uint minimum = length == 4 ? 0x10000 : length == 3 ? 0x800 : 0x80;
+    codePoint = 0xfffd;
+
+    if (length == 1 || lead > 0xf4 || length > available) {
+        return 1;
+    }
+
+    uint value = lead & (0x7f >> length);
+    for (int i = 1; i < length; ++i) {
+        if ((bytes[i] & 0xc0) != 0x80) {
+            return i;
+        }
+        value = (value << 6) | (bytes[i] & 0x3f);
+    }
+
+    if (value >= minimum && value <= 0x10ffff && (value < 0xd800 || value > 0xdfff)) {
+        codePoint = value;
+    }
+    return length;
+}
+
+QVector<PatternMatch> MultiPatternMatcher::findAll(const QString& text) const {
+    if (!compiled) {
+        return QVector<PatternMatch>();
+    }
+
+    if (literalSet) {
+        return findAllLiterals(text);
+    }
+
+    QVector<PatternMatch> matches;
+    const QChar* data = text.constData();
+    int length = text.length();
+    bool matchesEmpty = dfa.isAccepting(dfa.getInitialState());
+
+    int pos = 0;
+    while (pos <= length) {
+        if (!matchesEmpty) {
+            while (pos < length && !startClasses[dfa.classOf(data[pos])]) {
+                ++pos;
+            }
+            if (pos >= length) {
+                break;
+            }
+        }
+
+        PatternMatch match = longestMatchAt(text, pos);
+        if (match.isValid()) {
+            matches.append(match);
+            pos = match.length > 0 ? match.end() : match.end() + 1;
+        } else {
+            ++pos;
+        }
+    }
+
+    return matches;
+}
+
+QVector<PatternMatch> MultiPatternMatcher::findAllLiterals(const QString& text) const {
+    QVector<PatternMatch> matches;
+    const QChar* data = text.constData();
+    int length = text.length();
+    int state = 0;
+    PatternMatch best;
+
+    int i = 0;
+    while (i < length || best.isValid()) {
+        if (i >= length) {
+            matches.append(best);
+            i = best.end();
+            state = 0;
+            best = PatternMatch();
+            continue;
+        }
+
+        ushort u = data[i].unicode();
+        while (state > 0 && !acGoto[state].contains(u)) {
+            state = acFail[state];
+        }
+        state = acGoto[state].value(u, 0);
+        ++i;
+
+        if (acLongestPattern[state] >= 0) {
+            int start = i - acLongestLength[state];
+            if (!best.isValid() || start <= best.start) {
+                best = PatternMatch(start, acLongestLength[state], acLongestPattern[state]);
+            }
+        }
+
+
+        if (best.isValid() && i - acDepth[state] > best.start) {
+            matches.append(best);
+            i = best.end();
+            state = 0;
+            best = PatternMatch();
+        }
+    }
+
+    return matches;
+}
@@ -0,0 +1,121 @@
+#ifndef MULTIPATTERNMATCHER_H
+#define MULTIPATTERNMATCHER_H
+
+#include "./src/models/Automaton/Automaton.h"
+#include "CompiledDFA.h"
+#include "StaticDFA.h"
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QPair>
+
+struct PatternMatch {
+    int start;
+    int length;
+    int patternId;
+
+    PatternMatch(int s = -1, int len = 0, int id = -1)
+        : start(s), length(len), patternId(id) {}
+
+    bool isValid() const { return start >= 0; }
+    int end() const { return start + length; }
+};
+
+
+class MultiPatternMatcher {
+public:
+    MultiPatternMatcher();
+
+    int addPattern(const QString& regex);
+    int addAutomaton(const Automaton* automaton);
+    int addLiteral(const QString& literal);
+    template <int MaxStates, int MaxClasses>
+    int addStaticDFA(const StaticDFA<MaxStates, MaxClasses>& automaton);
+    void clear();
+
+    bool compile();
+    bool isCompiled() const { return compiled; }
+    bool isLiteralSet() const { return literalSet; }
+    int getPatternCount() const { return patternCount; }
+    const CompiledDFA& getCompiledDFA() const { return dfa; }
+
+
+    int match(const QString& input) const;
+    QVector<int> matchAll(const QString& input) const;
+    PatternMatch longestMatchAt(const QString& text, int pos) const;
+    PatternMatch longestMatchAt(const char* utf8, int size, int pos) const;
+    QVector<PatternMatch> findAll(const QString& text) const;
+
+private:
+    int patternCount;
+    bool compiled;
+    bool literalSet;
+
+
+    QVector<QVector<int>> epsilonEdges;
+    QVector<QVector<QPair<ushort, int>>> symbolEdges;
+    QVector<int> acceptPattern;
+    QVector<int> patternStarts;
+
+
+    QVector<QString> literals;
+    QHash<QString, QVector<int>> literalIds;
+    QVector<QHash<ushort, int>> acGoto;
+    QVector<int> acFail;
+    QVector<int> acDepth;
+    QVector<int> acLongestPattern;
+    QVector<int> acLongestLength;
+
+
+    CompiledDFA dfa;
+    QVector<QVector<int>> acceptSets;
+    QVector<bool> startClasses;
+    QVector<quint8> runStates;
+
+    enum RunKind : quint8 { NoRun, IdentifierRun, DigitRun };
+
+    int addNFAState();
+    bool isLiteralRegex(const QString& regex) const;
+    void closure(QVector<int>& states, QVector<int>& marks, int stamp) const;
+    bool buildUnionDFA();
+    void minimizeUnionDFA(QVector<QVector<QPair<ushort, int>>>& dfaEdges);
+    void findRunStates();
+    void buildAhoCorasick();
+    QVector<PatternMatch> findAllLiterals(const QString& text) const;
+    static int decodeUtf8(const uchar* bytes, int available, uint& codePoint);
+};
+
+
+template <int MaxStates, int MaxClasses>
+int MultiPatternMatcher::addStaticDFA(const StaticDFA<MaxStates, MaxClasses>& automaton) {
+    int id = patternCount++;
+    compiled = false;
+    literals.append(QString());
+
+    if (!automaton.valid) {
+        patternStarts.append(-1);
+        return id;
+    }
+
+    int first = acceptPattern.size();
+    for (int s = 0; s < automaton.stateCount; ++s) {
+        int state = addNFAState();
+        if (automaton.accepting[s]) {
+            acceptPattern[state] = id;
+        }
+    }
+
+    for (int s = 0; s < automaton.stateCount; ++s) {
+        for (int u = 0; u < 256; ++u) {
+            int target = automaton.next[s][automaton.byteClass[u]];
+            if (target >= 0) {
+                symbolEdges[first + s].append(qMakePair(ushort(u), first + target));
+            }
+        }
+    }
+
+    patternStarts.append(first);
+    return id;
+}
+
+#endif
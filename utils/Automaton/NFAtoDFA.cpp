@@ -1,6 +1,8 @@
 ﻿#include "NFAtoDFA.h"
-#include <QQueue>
+#include "./src/models/Automaton/AutomatonBuilder.h"
+#include <QHash>
 #include <QDebug>
+#include <algorithm>
 
 NFAtoDFA::NFAtoDFA() {}
 
@@ -9,104 +11,99 @@ Automaton* NFAtoDFA::convert(const Automaton* nfa) {
         return nullptr;
     }
 
-    Automaton* dfa = new Automaton("", "", AutomatonType::DFA);
-    dfa->setName(nfa->getName() + " (DFA)");
+    QSharedPointer<const AutomatonTopology> graph = nfa->getTopology();
+    AutomatonBuilder dfa("", nfa->getName() + " (DFA)", AutomatonType::DFA);
 
-    QSet<QString> alphabet = nfa->getAlphabet();
-    for (const auto& symbol : alphabet) {
-        dfa->addToAlphabet(symbol);
+    for (const auto& symbol : nfa->getAlphabet()) {
+        dfa.addToAlphabet(symbol);
     }
 
-    QSet<QString> initialNFAStates;
-    initialNFAStates.insert(nfa->getInitialStateId());
-    QSet<QString> initialDFAState = nfa->epsilonClosure(initialNFAStates);
+    QHash<QVector<int>, int> dfaStateIndex;
+    QVector<QVector<int>> dfaStates;
+    QVector<QString> dfaStateIds;
+    QVector<bool> member(graph->getStateCount(), false);
 
-    QMap<QString, QSet<QString>> dfaStateMap;
-    QQueue<QSet<QString>> unmarkedStates;
+    auto subsetIndex = [&](QVector<int>& subset) {
+        graph->epsilonClosure(subset, member);
+        for (int state : subset) {
+            member[state] = false;
+        }
+        std::sort(subset.begin(), subset.end());
 
-    QString initialStateId = setToString(initialDFAState);
-    dfaStateMap[initialStateId] = initialDFAState;
-    unmarkedStates.enqueue(initialDFAState);
+        int index = dfaStateIndex.value(subset, -1);
+        if (index >= 0) {
+            return index;
+        }
 
-    bool initialIsFinal = false;
-    for (const auto& nfaStateId : initialDFAState) {
-        const State* nfaState = nfa->getState(nfaStateId);
-        if (nfaState && nfaState->getIsFinal()) {
-            initialIsFinal = true;
-            break;
+        index = dfaStates.size();
+        QString stateId = setToString(*graph, subset);
+        bool isFinal = false;
+        for (int state : subset) {
+            isFinal = isFinal || graph->isFinal(state);
         }
-    }
 
-    State initialState(initialStateId, initialStateId, QPointF(100, 100));
-    initialState.setIsInitial(true);
-    initialState.setIsFinal(initialIsFinal);
-    dfa->addState(initialState);
-    dfa->setInitialState(initialStateId);
+        State newState(stateId, stateId, index == 0 ? QPointF(100, 100) : QPointF(0, 0));
+        newState.setIsInitial(index == 0);
+        newState.setIsFinal(isFinal);
+        dfa.addState(newState);
 
-    while (!unmarkedStates.isEmpty()) {
-        QSet<QString> currentSet = unmarkedStates.dequeue();
-        QString currentId = setToString(currentSet);
+        dfaStateIndex.insert(subset, index);
+        dfaStates.append(subset);
+        dfaStateIds.append(stateId);
+        return index;
+    };
 
-        for (const auto& symbol : alphabet) {
-            QSet<QString> nextSet = move(nfa, currentSet, symbol);
-            nextSet = nfa->epsilonClosure(nextSet);
+    QVector<int> initialSet;
+    initialSet.append(graph->getInitialState());
+    member[graph->getInitialState()] = true;
+    subsetIndex(initialSet);
 
-            if (nextSet.isEmpty()) {
+    QVector<QVector<int>> buckets(graph->getSymbolCount());
+    for (int current = 0; current < dfaStates.size(); ++current) {
+        move(*graph, dfaStates[current], buckets);
+
+        for (int symbol = AutomatonTopology::EPSILON + 1; symbol < buckets.size(); ++symbol) {
+            if (buckets[symbol].isEmpty()) {
                 continue;
             }
 
-            QString nextId = setToString(nextSet);
-
-            if (!dfaStateMap.contains(nextId)) {
-                dfaStateMap[nextId] = nextSet;
-                unmarkedStates.enqueue(nextSet);
-
-                bool isFinal = false;
-                for (const auto& nfaStateId : nextSet) {
-                    const State* nfaState = nfa->getState(nfaStateId);
-                    if (nfaState && nfaState->getIsFinal()) {
-                        isFinal = true;
-                        break;
-                    }
+            QVector<int> nextSet;
+            for (int target : buckets[symbol]) {
+                if (!member[target]) {
+                    member[target] = true;
+                    nextSet.append(target);
                 }
-
-                State newState(nextId, nextId, QPointF(0, 0));
-                newState.setIsFinal(isFinal);
-                dfa->addState(newState);
             }
+            buckets[symbol].clear();
 
-            Transition trans(currentId, nextId, symbol);
-            dfa->addTransition(trans);
+            int next = subsetIndex(nextSet);
+            dfa.addTransition(dfaStateIds[current], dfaStateIds[next], graph->getSymbol(symbol));
         }
     }
 
-    dfa->setType(AutomatonType::DFA);
-    return dfa;
+    return dfa.finish();
 }
 
-QString NFAtoDFA::setToString(const QSet<QString>& stateSet) {
+QString NFAtoDFA::setToString(const AutomatonTopology& nfa, const QVector<int>& stateSet) {
     if (stateSet.isEmpty()) {
         return "∅";
     }
 
-    QStringList list = stateSet.values();
+    QStringList list;
+    for (int state : stateSet) {
+        list.append(nfa.getStateId(state));
+    }
     list.sort();
     return "{" + list.join(",") + "}";
 }
 
-QSet<QString> NFAtoDFA::move(const Automaton* nfa, const QSet<QString>& states,
-                             const QString& symbol) {
-    QSet<QString> result;
-
-    for (const auto& stateId : states) {
-        const auto& transitions = nfa->getTransitionsFrom(stateId);
-
-        for (const auto& trans : transitions) {
-            if (trans.hasSymbol(symbol)) {
-                result.insert(trans.getToStateId());
+void NFAtoDFA::move(const AutomatonTopology& nfa, const QVector<int>& states,
+                    QVector<QVector<int>>& targets) {
+    for (int state : states) {
+        for (int e = nfa.edgeBegin(state); e < nfa.edgeEnd(state); ++e) {
+            if (nfa.edgeSymbol(e) != AutomatonTopology::EPSILON) {
+                targets[nfa.edgeSymbol(e)].append(nfa.edgeTarget(e));
             }
         }
     }
-
-    return result;
 }
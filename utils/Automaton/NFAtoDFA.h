@@ -3,7 +3,7 @@
 
 #include "./src/models/Automaton/Automaton.h"
 #include <QSet>
-#include <QMap>
+#include <QVector>
 #include <QString>
 
 class NFAtoDFA {
@@ -13,9 +13,9 @@ public:
     Automaton* convert(const Automaton* nfa);
 
 private:
-    QString setToString(const QSet<QString>& stateSet);
-    QSet<QString> move(const Automaton* nfa, const QSet<QString>& states,
-                       const QString& symbol);
+    QString setToString(const AutomatonTopology& nfa, const QVector<int>& stateSet);
+    void move(const AutomatonTopology& nfa, const QVector<int>& states,
+              QVector<QVector<int>>& targets);
 };
 
 #endif  
@@ -0,0 +1,516 @@
+#include "PikeVM.h"
+#include "RegexToNFA.h"
+#include "RegexCache.h"
+#include <QPair>
+#include <QSet>
+#include <algorithm>
+
+PikeVM::PikeVM() : groupCount(1), counterCount(0), counterThreshold(256), cursor(0) {}
+
+bool PikeVM::compile(const QString& regex, QString* error) {
+    program.clear();
+    nodes.clear();
+    groupCount = 1;
+    counterCount = 0;
+    pattern = regex;
+    cursor = 0;
+    parseError.clear();
+    fastPath = AutomatonSearcher();
+
+    if (regex.isEmpty()) {
+        if (error) *error = "Regex cannot be empty";
+        return false;
+    }
+
+    int root = parseAlternation();
+    if (root >= 0 && cursor < pattern.length()) {
+        parseError = "Unmatched closing parenthesis";
+        root = -1;
+    }
+
+    if (root < 0) {
+        if (error) *error = parseError;
+        nodes.clear();
+        groupCount = 1;
+        return false;
+    }
+
+    addInstruction(Opcode::Save, 0, 0);
+    generate(root);
+    addInstruction(Opcode::Save, 0, 1);
+    addInstruction(Opcode::Match);
+    nodes.clear();
+
+
+    if (counterCount == 0) {
+        RegexToNFA converter;
+        if (converter.isValidRegex(regex)) {
+            QSharedPointer<const Automaton> dfa = RegexCache::instance().get(regex, RegexStage::DFA);
+            if (!dfa.isNull()) {
+                fastPath.setAutomaton(dfa.data());
+            }
+        }
+    }
+
+    return true;
+}
+
+int PikeVM::addNode(NodeType type, int left, int right, QChar symbol, int group) {
+    Node node;
+    node.type = type;
+    node.symbol = symbol;
+    node.group = group;
+    node.left = left;
+    node.right = right;
+    node.min = 0;
+    node.max = 0;
+    nodes.append(node);
+    return nodes.size() - 1;
+}
+
+int PikeVM::parseAlternation() {
+    int left = parseConcatenation();
+    while (left >= 0 && cursor < pattern.length() && pattern[cursor] == '|') {
+        cursor++;
+        int right = parseConcatenation();
+        if (right < 0) {
+            return -1;
+        }
+        left = addNode(NodeType::Alternate, left, right);
+    }
+    return left;
+}
+
+int PikeVM::parseConcatenation() {
+    int node = -1;
+    while (cursor < pattern.length() && pattern[cursor] != '|' && pattern[cursor] != ')') {
+        if (pattern[cursor] == '.') {
+            if (node < 0 || !RegexToNFA::hasConcatOperands(pattern, cursor)) {
+                parseError = QString("Concatenation '.' needs an operand on both sides at position %1").arg(cursor);
+                return -1;
+            }
+            cursor++;
+            continue;
+        }
+        int next = parseRepetition();
+        if (next < 0) {
+            return -1;
+        }
+        node = (node < 0) ? next : addNode(NodeType::Concat, node, next);
+    }
+    return (node < 0) ? addNode(NodeType::Empty) : node;
+}
+
+int PikeVM::parseRepetition() {
+    int atom = parseAtom();
+    while (atom >= 0 && cursor < pattern.length()) {
+        QChar c = pattern[cursor];
+        if (c == '*') {
+            atom = addNode(NodeType::Star, atom);
+        } else if (c == '+') {
+            atom = addNode(NodeType::Plus, atom);
+        } else if (c == '?') {
+            atom = addNode(NodeType::Optional, atom);
+        } else if (c == '{') {
+            int min = 0, max = 0;
+            int start = cursor;
+            if (!RegexToNFA::parseRepetitionBounds(pattern, cursor, min, max)) {
+                parseError = QString("Invalid repetition at position %1").arg(start);
+                return -1;
+            }
+            atom = addNode(NodeType::Repeat, atom);
+            nodes[atom].min = min;
+            nodes[atom].max = max;
+        } else {
+            break;
+        }
+        cursor++;
+    }
+    return atom;
+}
+
+int PikeVM::parseAtom() {
+    QChar c = pattern[cursor];
+
+    if (c == '(') {
+        cursor++;
+        int group = groupCount++;
+        int inner = parseAlternation();
+        if (inner < 0) {
+            return -1;
+        }
+        if (cursor >= pattern.length() || pattern[cursor] != ')') {
+            parseError = "Unmatched opening parenthesis";
+            return -1;
+        }
+        cursor++;
+        return addNode(NodeType::Group, inner, -1, QChar(), group);
+    }
+
+    if (c == '*' || c == '+' || c == '?' || c == '{') {
+        parseError = QString("Nothing to repeat before '%1' at position %2").arg(c).arg(cursor);
+        return -1;
+    }
+
+    cursor++;
+    if (c == 'E' || c == QChar(0x03B5)) {
+        return addNode(NodeType::Empty);
+    }
+    return addNode(NodeType::Literal, -1, -1, c);
+}
+
+int PikeVM::addInstruction(Opcode op, ushort symbol, int x, int y) {
+    Instruction ins;
+    ins.op = op;
+    ins.symbol = symbol;
+    ins.x = x;
+    ins.y = y;
+    ins.counter = 0;
+    ins.min = 0;
+    ins.max = 0;
+    program.append(ins);
+    return program.size() - 1;
+}
+
+void PikeVM::generate(int index) {
+    const Node node = nodes[index];
+
+    switch (node.type) {
+    case NodeType::Empty:
+        break;
+
+    case NodeType::Literal:
+        addInstruction(Opcode::Char, node.symbol.unicode());
+        break;
+
+    case NodeType::Concat:
+        generate(node.left);
+        generate(node.right);
+        break;
+
+    case NodeType::Alternate: {
+        int split = addInstruction(Opcode::Split);
+        program[split].x = program.size();
+        generate(node.left);
+        int jump = addInstruction(Opcode::Jump);
+        program[split].y = program.size();
+        generate(node.right);
+        program[jump].x = program.size();
+        break;
+    }
+
+    case NodeType::Star: {
+        int split = addInstruction(Opcode::Split);
+        program[split].x = program.size();
+        generate(node.left);
+        addInstruction(Opcode::Jump, 0, split);
+        program[split].y = program.size();
+        break;
+    }
+
+    case NodeType::Plus: {
+        int body = program.size();
+        generate(node.left);
+        int split = addInstruction(Opcode::Split, 0, body);
+        program[split].y = program.size();
+        break;
+    }
+
+    case NodeType::Optional: {
+        int split = addInstruction(Opcode::Split);
+        program[split].x = program.size();
+        generate(node.left);
+        program[split].y = program.size();
+        break;
+    }
+
+    case NodeType::Group:
+        addInstruction(Opcode::Save, 0, node.group * 2);
+        generate(node.left);
+        addInstruction(Opcode::Save, 0, node.group * 2 + 1);
+        break;
+
+    case NodeType::Repeat:
+        generateRepeat(node);
+        break;
+    }
+}
+
+void PikeVM::generateRepeat(const Node& node) {
+    int bound = (node.max < 0) ? node.min : node.max;
+
+    if (counterThreshold >= 0 && bound > counterThreshold) {
+        int counter = counterCount++;
+        addInstruction(Opcode::CounterReset, 0, counter);
+        int loop = addInstruction(Opcode::CounterLoop, 0, 0);
+        program[loop].counter = counter;
+        program[loop].min = node.min;
+        program[loop].max = node.max;
+        program[loop].x = program.size();
+        generate(node.left);
+        int increment = addInstruction(Opcode::CounterIncrement, 0, counter);
+        program[increment].min = node.min;
+        program[increment].max = node.max;
+        addInstruction(Opcode::Jump, 0, loop);
+        program[loop].y = program.size();
+        return;
+    }
+
+    for (int i = 0; i < node.min; ++i) {
+        generate(node.left);
+    }
+
+    if (node.max < 0) {
+        int split = addInstruction(Opcode::Split);
+        program[split].x = program.size();
+        generate(node.left);
+        addInstruction(Opcode::Jump, 0, split);
+        program[split].y = program.size();
+        return;
+    }
+
+    QVector<int> splits;
+    for (int i = node.min; i < node.max; ++i) {
+        int split = addInstruction(Opcode::Split);
+        program[split].x = program.size();
+        splits.append(split);
+        generate(node.left);
+    }
+    for (int split : splits) {
+        program[split].y = program.size();
+    }
+}
+
+bool PikeVM::match(const QString& input, CaptureMatch* captures) const {
+    if (!isValid()) {
+        return false;
+    }
+
+    if (fastPath.isValid()) {
+        const CompiledDFA& dfa = fastPath.getCompiledDFA();
+        int state = dfa.getInitialState();
+        for (QChar c : input) {
+            state = dfa.next(state, c);
+            if (state == CompiledDFA::DEAD_STATE) {
+                return false;
+            }
+        }
+        if (!dfa.isAccepting(state)) {
+            return false;
+        }
+
+        if (groupCount == 1) {
+            if (captures) {
+                captures->spans = QVector<int>{0, int(input.length())};
+            }
+            return true;
+        }
+    }
+
+    CaptureMatch result = run(input, 0, input.length(), true, true);
+    if (captures) {
+        *captures = result;
+    }
+    return result.isValid();
+}
+
+CaptureMatch PikeVM::search(const QString& text, int from) const {
+    if (!isValid() || from < 0 || from > text.length()) {
+        return CaptureMatch();
+    }
+
+    if (fastPath.isValid()) {
+        AutomatonMatch span = fastPath.find(text, from);
+        if (!span.isValid()) {
+            return CaptureMatch();
+        }
+
+        if (groupCount == 1) {
+            CaptureMatch result;
+            result.spans = QVector<int>{span.start, span.end()};
+            return result;
+        }
+
+        CaptureMatch result = run(text, span.start, span.end(), true, true);
+        if (result.isValid()) {
+            return result;
+        }
+    }
+
+    return run(text, from, text.length(), false, false);
+}
+
+QVector<CaptureMatch> PikeVM::searchAll(const QString& text) const {
+    QVector<CaptureMatch> matches;
+    int from = 0;
+
+    while (from <= text.length()) {
+        CaptureMatch match = search(text, from);
+        if (!match.isValid()) {
+            break;
+        }
+
+        matches.append(match);
+        from = (match.end() > match.start()) ? match.end() : match.end() + 1;
+    }
+
+    return matches;
+}
+
+CaptureMatch PikeVM::run(const QString& text, int begin, int limit, bool anchored, bool mustReachLimit) const {
+    const int slots = groupCount * 2;
+    const int stride = slots + counterCount;
+    const int size = program.size();
+    const QChar* data = text.constData();
+
+    QVector<int> currentPcs;
+    QVector<int> nextPcs;
+    QVector<int> currentCaps;
+    QVector<int> nextCaps;
+    QVector<int> marks(size, 0);
+    QSet<QVector<int>> visited;
+    QVector<int> key(1 + counterCount);
+    QVector<int> initial(stride, -1);
+    QVector<int> scratch(stride, -1);
+    QVector<QPair<int, int>> frames;
+    int stamp = 0;
+    int visitedStamp = 0;
+    CaptureMatch best;
+
+    auto firstVisit = [&](int pc) {
+        if (counterCount == 0) {
+            if (marks[pc] == stamp) {
+                return false;
+            }
+            marks[pc] = stamp;
+            return true;
+        }
+
+        if (visitedStamp != stamp) {
+            visitedStamp = stamp;
+            visited.clear();
+        }
+        key[0] = pc;
+        std::copy(scratch.constBegin() + slots, scratch.constEnd(), key.begin() + 1);
+        if (visited.contains(key)) {
+            return false;
+        }
+        visited.insert(key);
+        return true;
+    };
+
+
+    auto addThread = [&](QVector<int>& pcs, QVector<int>& caps, int startPc, const int* startCaps, int pos) {
+        std::copy(startCaps, startCaps + stride, scratch.begin());
+        frames.clear();
+        frames.append(qMakePair(startPc, 0));
+
+        while (!frames.isEmpty()) {
+            QPair<int, int> frame = frames.takeLast();
+            if (frame.first < 0) {
+                scratch[-frame.first - 1] = frame.second;
+                continue;
+            }
+
+            int pc = frame.first;
+            if (!firstVisit(pc)) {
+                continue;
+            }
+
+            const Instruction& ins = program[pc];
+            switch (ins.op) {
+            case Opcode::Jump:
+                frames.append(qMakePair(ins.x, 0));
+                break;
+            case Opcode::Split:
+                frames.append(qMakePair(ins.y, 0));
+                frames.append(qMakePair(ins.x, 0));
+                break;
+            case Opcode::Save:
+                frames.append(qMakePair(-ins.x - 1, scratch[ins.x]));
+                scratch[ins.x] = pos;
+                frames.append(qMakePair(pc + 1, 0));
+                break;
+            case Opcode::CounterReset: {
+                int slot = slots + ins.x;
+                frames.append(qMakePair(-slot - 1, scratch[slot]));
+                scratch[slot] = 0;
+                frames.append(qMakePair(pc + 1, 0));
+                break;
+            }
+            case Opcode::CounterLoop: {
+                int slot = slots + ins.counter;
+                int count = scratch[slot];
+                if (count >= ins.min) {
+                    frames.append(qMakePair(-slot - 1, count));
+                    frames.append(qMakePair(ins.y, 0));
+                    frames.append(qMakePair(-slot - 1, -1));
+                }
+                if (ins.max < 0 || count < ins.max) {
+                    frames.append(qMakePair(ins.x, 0));
+                }
+                break;
+            }
+            case Opcode::CounterIncrement: {
+                int slot = slots + ins.x;
+                int count = scratch[slot] + 1;
+                frames.append(qMakePair(-slot - 1, scratch[slot]));
+                scratch[slot] = (ins.max < 0) ? qMin(count, ins.min) : count;
+                frames.append(qMakePair(pc + 1, 0));
+                break;
+            }
+            default:
+                pcs.append(pc);
+                caps.append(scratch);
+                break;
+            }
+        }
+    };
+
+    ++stamp;
+    addThread(currentPcs, currentCaps, 0, initial.constData(), begin);
+
+    for (int pos = begin; ; ++pos) {
+        if (currentPcs.isEmpty() && (best.isValid() || anchored)) {
+            break;
+        }
+
+        ++stamp;
+        nextPcs.clear();
+        nextCaps.clear();
+
+        for (int i = 0; i < currentPcs.size(); ++i) {
+            int pc = currentPcs[i];
+            const int* caps = currentCaps.constData() + i * stride;
+            if (best.isValid() && caps[0] > best.start()) {
+                continue;
+            }
+
+            const Instruction& ins = program[pc];
+            if (ins.op == Opcode::Match) {
+                if (mustReachLimit && pos != limit) {
+                    continue;
+                }
+                if (!best.isValid() || caps[0] < best.start() ||
+                    (caps[0] == best.start() && pos > best.end())) {
+                    best.spans = QVector<int>(caps, caps + slots);
+                }
+            } else if (ins.op == Opcode::Char && pos < limit && data[pos].unicode() == ins.symbol) {
+                addThread(nextPcs, nextCaps, pc + 1, caps, pos + 1);
+            }
+        }
+
+        if (pos >= limit) {
+            break;
+        }
+
+        if (!anchored && !best.isValid()) {
+            addThread(nextPcs, nextCaps, 0, initial.constData(), pos + 1);
+        }
+
+        currentPcs.swap(nextPcs);
+        currentCaps.swap(nextCaps);
+    }
+
+    return best;
+}
@@ -0,0 +1,93 @@
+#ifndef PIKEVM_H
+#define PIKEVM_H
+
+#include "AutomatonSearcher.h"
+#include <QString>
+#include <QVector>
+
+struct CaptureMatch {
+    QVector<int> spans;
+
+    bool isValid() const { return !spans.isEmpty() && spans[0] >= 0; }
+    int groupCount() const { return spans.size() / 2; }
+    int start(int group = 0) const { return spans.value(group * 2, -1); }
+    int end(int group = 0) const { return spans.value(group * 2 + 1, -1); }
+
+    QString captured(const QString& text, int group = 0) const {
+        int s = start(group);
+        int e = end(group);
+        return (s >= 0 && e >= s) ? text.mid(s, e - s) : QString();
+    }
+};
+
+
+class PikeVM {
+public:
+    PikeVM();
+
+    bool compile(const QString& regex, QString* error = nullptr);
+    bool isValid() const { return !program.isEmpty(); }
+    int getGroupCount() const { return groupCount; }
+    bool hasDFAFastPath() const { return fastPath.isValid(); }
+    int getProgramSize() const { return program.size(); }
+
+     
+    void setCounterThreshold(int threshold) { counterThreshold = threshold; }
+    int getCounterThreshold() const { return counterThreshold; }
+
+
+    bool match(const QString& input, CaptureMatch* captures = nullptr) const;
+    CaptureMatch search(const QString& text, int from = 0) const;
+    QVector<CaptureMatch> searchAll(const QString& text) const;
+
+private:
+    enum class Opcode { Char, Split, Jump, Save, Match, CounterReset, CounterLoop, CounterIncrement };
+
+    struct Instruction {
+        Opcode op;
+        ushort symbol;
+        int x;
+        int y;
+        int counter;
+        int min;
+        int max;
+    };
+
+    enum class NodeType { Empty, Literal, Concat, Alternate, Star, Plus, Optional, Group, Repeat };
+
+    struct Node {
+        NodeType type;
+        QChar symbol;
+        int group;
+        int left;
+        int right;
+        int min;
+        int max;
+    };
+
+    QVector<Instruction> program;
+    int groupCount;
+    int counterCount;
+    int counterThreshold;
+    AutomatonSearcher fastPath;
+
+
+    QVector<Node> nodes;
+    QString pattern;
+    int cursor;
+    QString parseError;
+
+    int parseAlternation();
+    int parseConcatenation();
+    int parseRepetition();
+    int parseAtom();
+    int addNode(NodeType type, int left = -1, int right = -1, QChar symbol = QChar(), int group = 0);
+
+    int addInstruction(Opcode op, ushort symbol = 0, int x = 0, int y = 0);
+    void generate(int node);
+    void generateRepeat(const Node& node);
+
+    CaptureMatch run(const QString& text, int begin, int limit, bool anchored, bool mustReachLimit) const;
+};
+
+#endif
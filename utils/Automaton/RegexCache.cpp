@@ -0,0 +1,134 @@
+#include "RegexCache.h"
+#include "RegexToNFA.h"
+#include "NFAtoDFA.h"
+#include "DFAMinimizer.h"
+#include <QMutexLocker>
+
+RegexCache::RegexCache() : entries(DEFAULT_BUDGET), hits(0), misses(0) {}
+
+RegexCache& RegexCache::instance() {
+    static RegexCache cache;
+    return cache;
+}
+
+QSharedPointer<const Automaton> RegexCache::get(const QString& regex, RegexStage stage, quint32 flags) {
+    RegexCacheKey key{regex, flags, stage};
+
+    {
+        QMutexLocker locker(&mutex);
+        QSharedPointer<const Automaton>* cached = entries.object(key);
+        if (cached) {
+            hits++;
+            return *cached;
+        }
+        misses++;
+    }
+
+
+    Automaton* automaton = build(regex, stage, flags);
+    if (!automaton) {
+        return QSharedPointer<const Automaton>();
+    }
+    automaton->getTopology();
+
+    QMutexLocker locker(&mutex);
+    QSharedPointer<const Automaton>* cached = entries.object(key);
+    if (cached) {
+        delete automaton;
+        return *cached;
+    }
+
+    QSharedPointer<const Automaton> shared(automaton);
+    entries.insert(key, new QSharedPointer<const Automaton>(shared), estimateBytes(automaton));
+    return shared;
+}
+
+Automaton* RegexCache::build(const QString& regex, RegexStage stage, quint32 flags) {
+    switch (stage) {
+    case RegexStage::NFA: {
+        RegexToNFA converter;
+        return converter.convert(regex);
+    }
+
+    case RegexStage::DFA: {
+        QSharedPointer<const Automaton> nfa = get(regex, RegexStage::NFA, flags);
+        if (nfa.isNull()) {
+            return nullptr;
+        }
+        NFAtoDFA converter;
+        return converter.convert(nfa.data());
+    }
+
+    case RegexStage::MinimalDFA: {
+        QSharedPointer<const Automaton> dfa = get(regex, RegexStage::DFA, flags);
+        if (dfa.isNull()) {
+            return nullptr;
+        }
+        DFAMinimizer minimizer;
+        return minimizer.minimize(dfa.data());
+    }
+    }
+
+    return nullptr;
+}
+
+void RegexCache::setByteBudget(qint64 bytes) {
+    QMutexLocker locker(&mutex);
+    entries.setMaxCost(qMax<qint64>(0, bytes));
+}
+
+qint64 RegexCache::getByteBudget() const {
+    QMutexLocker locker(&mutex);
+    return entries.maxCost();
+}
+
+void RegexCache::clear() {
+    QMutexLocker locker(&mutex);
+    entries.clear();
+}
+
+RegexCacheStatistics RegexCache::getStatistics() const {
+    QMutexLocker locker(&mutex);
+    RegexCacheStatistics stats;
+    stats.hits = hits;
+    stats.misses = misses;
+    stats.entries = entries.size();
+    stats.bytes = entries.totalCost();
+    stats.budget = entries.maxCost();
+    return stats;
+}
+
+void RegexCache::resetStatistics() {
+    QMutexLocker locker(&mutex);
+    hits = 0;
+    misses = 0;
+}
+
+qint64 RegexCache::estimateBytes(const Automaton* automaton) {
+    if (!automaton) {
+        return 0;
+    }
+
+    auto stringBytes = [](const QString& s) {
+        return qint64(sizeof(QString)) + qint64(s.size()) * 2;
+    };
+
+    qint64 bytes = sizeof(Automaton) + stringBytes(automaton->getId()) + stringBytes(automaton->getName());
+
+    for (const auto& state : automaton->getStates()) {
+        bytes += sizeof(State) + stringBytes(state.getId()) + stringBytes(state.getLabel());
+    }
+
+    for (const auto& t : automaton->getTransitions()) {
+        bytes += sizeof(Transition) + stringBytes(t.getFromStateId()) + stringBytes(t.getToStateId());
+        for (const auto& sym : t.getSymbols()) {
+            bytes += stringBytes(sym) + 2 * sizeof(void*);
+        }
+    }
+
+    for (const auto& sym : automaton->getAlphabet()) {
+        bytes += stringBytes(sym) + 2 * sizeof(void*);
+    }
+
+    return bytes;
+}
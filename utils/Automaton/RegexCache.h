@@ -0,0 +1,73 @@
+#ifndef REGEXCACHE_H
+#define REGEXCACHE_H
+
+#include "./src/models/Automaton/Automaton.h"
+#include <QString>
+#include <QCache>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QHash>
+
+enum class RegexStage {
+    NFA,
+    DFA,
+    MinimalDFA
+};
+
+struct RegexCacheKey {
+    QString regex;
+    quint32 flags;
+    RegexStage stage;
+
+    bool operator==(const RegexCacheKey& other) const {
+        return stage == other.stage && flags == other.flags && regex == other.regex;
+    }
+};
+
+inline size_t qHash(const RegexCacheKey& key, size_t seed = 0) {
+    return qHash(key.regex, seed) ^ (size_t(key.flags) * 31u) ^ size_t(key.stage);
+}
+
+struct RegexCacheStatistics {
+    quint64 hits;
+    quint64 misses;
+    int entries;
+    qint64 bytes;
+    qint64 budget;
+};
+
+
+class RegexCache {
+public:
+    static RegexCache& instance();
+
+
+    QSharedPointer<const Automaton> get(const QString& regex,
+                                        RegexStage stage = RegexStage::NFA,
+                                        quint32 flags = 0);
+
+    void setByteBudget(qint64 bytes);
+    qint64 getByteBudget() const;
+    void clear();
+
+    RegexCacheStatistics getStatistics() const;
+    void resetStatistics();
+
+    static qint64 estimateBytes(const Automaton* automaton);
+
+private:
+    RegexCache();
+    RegexCache(const RegexCache&) = delete;
+    RegexCache& operator=(const RegexCache&) = delete;
+
+    static constexpr qint64 DEFAULT_BUDGET = 16 * 1024 * 1024;
+
+    mutable QMutex mutex;
+    QCache<RegexCacheKey, QSharedPointer<const Automaton>> entries;
+    quint64 hits;
+    quint64 misses;
+
+    Automaton* build(const QString& regex, RegexStage stage, quint32 flags);
+};
+
+#endif
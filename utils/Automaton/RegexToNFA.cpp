@@ -1,11 +1,31 @@
 #include "RegexToNFA.h"
+#include "./src/models/Automaton/AutomatonBuilder.h"
 #include <QDebug>
+#include <QHash>
 #include <QPointF>
 
 RegexToNFA::RegexToNFA() : stateCounter(0) {}
 
-QString RegexToNFA::generateStateId() {
-    return QString("q%1").arg(stateCounter++);
+int RegexToNFA::newState() {
+    return stateCounter++;
+}
+
+void RegexToNFA::addEdge(int from, int to, QChar symbol) {
+    Edge edge;
+    edge.from = from;
+    edge.to = to;
+    edge.symbol = symbol;
+    edge.epsilon = false;
+    edges.append(edge);
+}
+
+void RegexToNFA::addEpsilon(int from, int to) {
+    Edge edge;
+    edge.from = from;
+    edge.to = to;
+    edge.symbol = QChar();
+    edge.epsilon = true;
+    edges.append(edge);
 }
 
 bool RegexToNFA::isValidRegex(const QString& regex, QString* error) {
@@ -17,6 +37,19 @@ bool RegexToNFA::isValidRegex(const QString& regex, QString* error) {
     int parenCount = 0;
     for (int i = 0; i < regex.length(); i++) {
         QChar c = regex[i];
+        if (c == '{' && i > 0) {
+            int min = 0, max = 0;
+            int start = i;
+            if (!parseRepetitionBounds(regex, i, min, max)) {
+                if (error) *error = QString("Invalid repetition at position %1").arg(start);
+                return false;
+            }
+            continue;
+        }
+        if (c == '.' && !hasConcatOperands(regex, i)) {
+            if (error) *error = QString("Concatenation '.' needs an operand on both sides at position %1").arg(i);
+            return false;
+        }
         if (c == '(') parenCount++;
         else if (c == ')') {
             parenCount--;
@@ -27,7 +60,7 @@ bool RegexToNFA::isValidRegex(const QString& regex, QString* error) {
         }
         
          
-        if (i == 0 && (c == '*' || c == '+' || c == '?' || c == '|')) {
+        if (i == 0 && (c == '*' || c == '+' || c == '?' || c == '|' || c == '{')) {
             if (error) *error = QString("Invalid operator '%1' at start").arg(c);
             return false;
         }
@@ -41,244 +74,279 @@ bool RegexToNFA::isValidRegex(const QString& regex, QString* error) {
     return true;
 }
 
-RegexToNFA::NFAFragment RegexToNFA::createLiteralNFA(QChar symbol) {
-    NFAFragment frag;
-    frag.startStateId = generateStateId();
-    frag.endStateId = generateStateId();
-    
-    State start(frag.startStateId, frag.startStateId);
-    State end(frag.endStateId, frag.endStateId);
-    
-    frag.states.append(start);
-    frag.states.append(end);
-    
-    Transition trans(frag.startStateId, frag.endStateId, symbol);
-    frag.transitions.append(trans);
-    
-    return frag;
+bool RegexToNFA::hasConcatOperands(const QString& regex, int pos) {
+    if (pos == 0 || pos + 1 >= regex.length()) {
+        return false;
+    }
+    QChar prev = regex[pos - 1];
+    QChar next = regex[pos + 1];
+    return prev != '(' && prev != '|' && prev != '.' &&
+           next != ')' && next != '|' && next != '.' && next != '*' && next != '+' && next != '?' && next != '{';
 }
 
-RegexToNFA::NFAFragment RegexToNFA::createEpsilonNFA() {
+bool RegexToNFA::parseRepetitionBounds(const QString& regex, int& pos, int& min, int& max) {
+    int i = pos;
+    if (i >= regex.length() || regex[i] != '{') {
+        return false;
+    }
+    i++;
+
+    auto readNumber = [&](int& value) {
+        int begin = i;
+        value = 0;
+        while (i < regex.length() && regex[i].isDigit() && value <= REPEAT_COUNT_LIMIT) {
+            value = value * 10 + regex[i].digitValue();
+            i++;
+        }
+        return i > begin;
+    };
+
+    if (!readNumber(min)) {
+        return false;
+    }
+    max = min;
+
+    if (i < regex.length() && regex[i] == ',') {
+        i++;
+        if (!readNumber(max)) {
+            max = -1;
+        }
+    }
+
+    if (i >= regex.length() || regex[i] != '}') {
+        return false;
+    }
+    if (min > REPEAT_COUNT_LIMIT || max > REPEAT_COUNT_LIMIT || (max >= 0 && max < min)) {
+        return false;
+    }
+
+    pos = i;
+    return true;
+}
+
+RegexToNFA::NFAFragment RegexToNFA::makeFragment(int start, int end, int firstState, int firstEdge) const {
     NFAFragment frag;
-    frag.startStateId = generateStateId();
-    frag.endStateId = generateStateId();
-    
-    State start(frag.startStateId, frag.startStateId);
-    State end(frag.endStateId, frag.endStateId);
-    
-    frag.states.append(start);
-    frag.states.append(end);
-    
-    Transition trans(frag.startStateId, frag.endStateId, "E");
-    frag.transitions.append(trans);
-    
+    frag.start = start;
+    frag.end = end;
+    frag.firstState = firstState;
+    frag.stateEnd = stateCounter;
+    frag.firstEdge = firstEdge;
+    frag.edgeEnd = edges.size();
     return frag;
 }
 
-void RegexToNFA::mergeFragments(NFAFragment& target, const NFAFragment& source) {
-    target.states.append(source.states);
-    target.transitions.append(source.transitions);
+RegexToNFA::NFAFragment RegexToNFA::createLiteralNFA(QChar symbol) {
+    int firstEdge = edges.size();
+    int start = newState();
+    int end = newState();
+    addEdge(start, end, symbol);
+    return makeFragment(start, end, start, firstEdge);
+}
+
+RegexToNFA::NFAFragment RegexToNFA::createEpsilonNFA() {
+    int firstEdge = edges.size();
+    int start = newState();
+    int end = newState();
+    addEpsilon(start, end);
+    return makeFragment(start, end, start, firstEdge);
 }
 
 RegexToNFA::NFAFragment RegexToNFA::concatenate(NFAFragment a, NFAFragment b) {
-    NFAFragment result;
-    result.startStateId = a.startStateId;
-    result.endStateId = b.endStateId;
-    
-     
-    mergeFragments(result, a);
-    mergeFragments(result, b);
-    
-     
-    Transition epsilon(a.endStateId, b.startStateId, "E");
-    result.transitions.append(epsilon);
-    
-    return result;
+    addEpsilon(a.end, b.start);
+    return makeFragment(a.start, b.end, a.firstState, a.firstEdge);
 }
 
 RegexToNFA::NFAFragment RegexToNFA::alternate(NFAFragment a, NFAFragment b) {
-    NFAFragment result;
-    result.startStateId = generateStateId();
-    result.endStateId = generateStateId();
-    
-    State newStart(result.startStateId, result.startStateId);
-    State newEnd(result.endStateId, result.endStateId);
-    
-    result.states.append(newStart);
-    result.states.append(newEnd);
-    
-     
-    mergeFragments(result, a);
-    mergeFragments(result, b);
-    
+    int start = newState();
+    int end = newState();
+
      
-    result.transitions.append(Transition(result.startStateId, a.startStateId, "E"));
-    result.transitions.append(Transition(result.startStateId, b.startStateId, "E"));
-    
+    addEpsilon(start, a.start);
+    addEpsilon(start, b.start);
+
      
-    result.transitions.append(Transition(a.endStateId, result.endStateId, "E"));
-    result.transitions.append(Transition(b.endStateId, result.endStateId, "E"));
-    
-    return result;
+    addEpsilon(a.end, end);
+    addEpsilon(b.end, end);
+
+    return makeFragment(start, end, a.firstState, a.firstEdge);
 }
 
 RegexToNFA::NFAFragment RegexToNFA::kleeneStar(NFAFragment a) {
-    NFAFragment result;
-    result.startStateId = generateStateId();
-    result.endStateId = generateStateId();
-    
-    State newStart(result.startStateId, result.startStateId);
-    State newEnd(result.endStateId, result.endStateId);
-    
-    result.states.append(newStart);
-    result.states.append(newEnd);
-    mergeFragments(result, a);
-    
+    int start = newState();
+    int end = newState();
+
      
-    result.transitions.append(Transition(result.startStateId, a.startStateId, "E"));
-    result.transitions.append(Transition(result.startStateId, result.endStateId, "E"));
-    
+    addEpsilon(start, a.start);
+    addEpsilon(start, end);
+
      
-    result.transitions.append(Transition(a.endStateId, a.startStateId, "E"));
-    
+    addEpsilon(a.end, a.start);
+
      
-    result.transitions.append(Transition(a.endStateId, result.endStateId, "E"));
-    
-    return result;
+    addEpsilon(a.end, end);
+
+    return makeFragment(start, end, a.firstState, a.firstEdge);
 }
 
 RegexToNFA::NFAFragment RegexToNFA::kleenePlus(NFAFragment a) {
-     
-    NFAFragment star = kleeneStar(a);
-    
-     
-    NFAFragment aCopy;
-    aCopy.startStateId = generateStateId();
-    aCopy.endStateId = generateStateId();
-    
-    State start(aCopy.startStateId, aCopy.startStateId);
-    State end(aCopy.endStateId, aCopy.endStateId);
-    aCopy.states.append(start);
-    aCopy.states.append(end);
-    
-     
-    for (const auto& trans : a.transitions) {
-        QString from = (trans.getFromStateId() == a.startStateId) ? aCopy.startStateId : trans.getFromStateId();
-        QString to = (trans.getToStateId() == a.endStateId) ? aCopy.endStateId : trans.getToStateId();
-        aCopy.transitions.append(Transition(from, to, trans.getSymbols()));
-    }
-    
-    return concatenate(aCopy, star);
+    return repeat(a, 1, -1);
 }
 
 RegexToNFA::NFAFragment RegexToNFA::optional(NFAFragment a) {
-    NFAFragment result;
-    result.startStateId = generateStateId();
-    result.endStateId = generateStateId();
-    
-    State newStart(result.startStateId, result.startStateId);
-    State newEnd(result.endStateId, result.endStateId);
-    
-    result.states.append(newStart);
-    result.states.append(newEnd);
-    mergeFragments(result, a);
-    
+    int start = newState();
+    int end = newState();
+
      
-    result.transitions.append(Transition(result.startStateId, a.startStateId, "E"));
-    
+    addEpsilon(start, a.start);
+
      
-    result.transitions.append(Transition(result.startStateId, result.endStateId, "E"));
-    
+    addEpsilon(start, end);
+
      
-    result.transitions.append(Transition(a.endStateId, result.endStateId, "E"));
-    
-    return result;
+    addEpsilon(a.end, end);
+
+    return makeFragment(start, end, a.firstState, a.firstEdge);
+}
+
+RegexToNFA::NFAFragment RegexToNFA::cloneFragment(const NFAFragment& a) {
+    int offset = stateCounter - a.firstState;
+    int firstEdge = edges.size();
+    stateCounter += a.stateEnd - a.firstState;
+
+    for (int i = a.firstEdge; i < a.edgeEnd; i++) {
+        Edge edge = edges[i];
+        edge.from += offset;
+        edge.to += offset;
+        edges.append(edge);
+    }
+
+    return makeFragment(a.start + offset, a.end + offset, a.firstState + offset, firstEdge);
+}
+
+RegexToNFA::NFAFragment RegexToNFA::repeat(NFAFragment a, int min, int max) {
+    if (max == 0) {
+        stateCounter = a.firstState;
+        edges.resize(a.firstEdge);
+        return createEpsilonNFA();
+    }
+    if (min == 0 && max < 0) {
+        return kleeneStar(a);
+    }
+
+    int copies = (max < 0) ? min : max;
+    edges.reserve(edges.size() + copies * (a.edgeEnd - a.firstEdge + 2) + 8);
+
+    int start = newState();
+    int tail = start;
+    QVector<int> exits;
+    for (int i = 0; i < copies; i++) {
+        NFAFragment part = (i == 0) ? a : cloneFragment(a);
+        if (i >= min) {
+            exits.append(tail);
+        }
+        addEpsilon(tail, part.start);
+        tail = part.end;
+    }
+
+    if (max < 0) {
+        NFAFragment loop = kleeneStar(cloneFragment(a));
+        addEpsilon(tail, loop.start);
+        tail = loop.end;
+    }
+
+    int end = newState();
+    addEpsilon(tail, end);
+    for (int from : exits) {
+        addEpsilon(from, end);
+    }
+
+    return makeFragment(start, end, a.firstState, a.firstEdge);
 }
 
-bool RegexToNFA::isOperator(QChar c) {
-    return c == '|' || c == '*' || c == '+' || c == '?' || c == '.';
+QVector<RegexToNFA::RegexToken> RegexToNFA::tokenize(const QString& regex) {
+    QVector<RegexToken> tokens;
+    tokens.reserve(regex.length());
+
+    for (int i = 0; i < regex.length(); i++) {
+        QChar c = regex[i];
+        RegexToken token{c, false, 0, 0};
+        if (c == '{' && parseRepetitionBounds(regex, i, token.min, token.max)) {
+            token.isOperator = true;
+        } else {
+            token.isOperator = c == '|' || c == '*' || c == '+' || c == '?' || c == '.' || c == '(' || c == ')';
+        }
+        tokens.append(token);
+    }
+
+    return tokens;
 }
 
-int RegexToNFA::precedence(QChar op) {
-    switch (op.toLatin1()) {
+int RegexToNFA::precedence(const RegexToken& op) {
+    if (!op.isOperator) {
+        return 0;
+    }
+    switch (op.symbol.toLatin1()) {
         case '|': return 1;
         case '.': return 2;   
         case '*':
         case '+':
-        case '?': return 3;
+        case '?':
+        case '{': return 3;
         default: return 0;
     }
 }
 
-QString RegexToNFA::insertConcatOperator(const QString& regex) {
-    QString result;
-    
-    for (int i = 0; i < regex.length(); i++) {
-        QChar c1 = regex[i];
-        result += c1;
-        
-        if (i + 1 < regex.length()) {
-            QChar c2 = regex[i + 1];
-            
-             
-             
-             
-             
-             
-             
-             
-             
-             
-             
-             
-            
-            bool needsConcat = false;
-            
-            if (c1 != '(' && c1 != '|' && c2 != ')' && c2 != '|' && c2 != '*' && c2 != '+' && c2 != '?') {
-                needsConcat = true;
-            }
-            
-            if (needsConcat) {
-                result += '.';
+QVector<RegexToNFA::RegexToken> RegexToNFA::insertConcatOperator(const QVector<RegexToken>& regex) {
+    QVector<RegexToken> result;
+    result.reserve(regex.size() * 2);
+
+    for (int i = 0; i < regex.size(); i++) {
+        const RegexToken& t1 = regex[i];
+        result.append(t1);
+
+        if (i + 1 < regex.size()) {
+            const RegexToken& t2 = regex[i + 1];
+            if (!t1.is('(') && !t1.is('|') && !t1.is('.') && !t2.is(')') && !t2.is('|') && !t2.is('.') &&
+                !t2.is('*') && !t2.is('+') && !t2.is('?') && !t2.is('{')) {
+                result.append(RegexToken{QLatin1Char('.'), true, 0, 0});
             }
         }
     }
-    
+
     return result;
 }
 
-QString RegexToNFA::infixToPostfix(const QString& regex) {
-    QString withConcat = insertConcatOperator(regex);
-    QString postfix;
-    QStack<QChar> stack;
-    
-    for (QChar c : withConcat) {
-        if (c == '(') {
-            stack.push(c);
+QVector<RegexToNFA::RegexToken> RegexToNFA::infixToPostfix(const QVector<RegexToken>& regex) {
+    QVector<RegexToken> withConcat = insertConcatOperator(regex);
+    QVector<RegexToken> postfix;
+    QStack<RegexToken> stack;
+
+    for (const RegexToken& t : withConcat) {
+        if (t.is('(')) {
+            stack.push(t);
         }
-        else if (c == ')') {
-            while (!stack.isEmpty() && stack.top() != '(') {
-                postfix += stack.pop();
+        else if (t.is(')')) {
+            while (!stack.isEmpty() && !stack.top().is('(')) {
+                postfix.append(stack.pop());
             }
             if (!stack.isEmpty()) stack.pop();  
         }
-        else if (isOperator(c)) {
-            while (!stack.isEmpty() && stack.top() != '(' && 
-                   precedence(stack.top()) >= precedence(c)) {
-                postfix += stack.pop();
+        else if (t.isOperator) {
+            while (!stack.isEmpty() && !stack.top().is('(') &&
+                   precedence(stack.top()) >= precedence(t)) {
+                postfix.append(stack.pop());
             }
-            stack.push(c);
+            stack.push(t);
         }
         else {
-             
-            postfix += c;
+            postfix.append(t);
         }
     }
-    
+
     while (!stack.isEmpty()) {
-        postfix += stack.pop();
+        postfix.append(stack.pop());
     }
-    
+
     return postfix;
 }
 
@@ -290,12 +358,22 @@ Automaton* RegexToNFA::convert(const QString& regex) {
     }
     
     stateCounter = 0;
-    QString postfix = infixToPostfix(regex);
+    edges.clear();
+    QVector<RegexToken> postfix = infixToPostfix(tokenize(regex));
     
     QStack<NFAFragment> stack;
     
-    for (QChar c : postfix) {
-        if (c == '|') {
+    for (const RegexToken& token : postfix) {
+        QChar c = token.symbol;
+        if (!token.isOperator) {
+             
+            if (c == 'E' || c == QChar(0x03B5)) {
+                stack.push(createEpsilonNFA());
+            } else {
+                stack.push(createLiteralNFA(c));
+            }
+        }
+        else if (c == '|') {
             if (stack.size() < 2) return nullptr;
             NFAFragment b = stack.pop();
             NFAFragment a = stack.pop();
@@ -322,13 +400,10 @@ Automaton* RegexToNFA::convert(const QString& regex) {
             NFAFragment a = stack.pop();
             stack.push(optional(a));
         }
-        else {
-             
-            if (c == 'E' || c == QChar(0x03B5)) {
-                stack.push(createEpsilonNFA());
-            } else {
-                stack.push(createLiteralNFA(c));
-            }
+        else if (c == '{') {
+            if (stack.isEmpty()) return nullptr;
+            NFAFragment a = stack.pop();
+            stack.push(repeat(a, token.min, token.max));
         }
     }
     
@@ -340,51 +415,29 @@ Automaton* RegexToNFA::convert(const QString& regex) {
     NFAFragment final = stack.pop();
     
      
-    Automaton* nfa = new Automaton(QString("nfa_%1").arg(stateCounter), 
-                                    QString("NFA from /%1/").arg(regex), 
-                                    AutomatonType::NFA);
-    
-     
-    for (const State& state : final.states) {
-        nfa->addState(state);
-    }
-    
-     
-    State* startState = nfa->getState(final.startStateId);
-    if (startState) {
-        startState->setIsInitial(true);
-        nfa->setInitialState(final.startStateId);
-    }
+    AutomatonBuilder nfa(QString("nfa_%1").arg(stateCounter), 
+                         QString("NFA from /%1/").arg(regex), 
+                         AutomatonType::NFA);
+    nfa.reserve(stateCounter, edges.size());
     
      
-    State* endState = nfa->getState(final.endStateId);
-    if (endState) {
-        endState->setIsFinal(true);
+    QVector<QString> ids;
+    ids.reserve(stateCounter);
+    int cols = qCeil(qSqrt(stateCounter));
+    
+    for (int i = 0; i < stateCounter; i++) {
+        ids.append(QString("q%1").arg(i));
+        State state(ids[i], ids[i], QPointF(100 + (i % cols) * 120, 100 + (i / cols) * 120));
+        state.setIsInitial(i == final.start);
+        state.setIsFinal(i == final.end);
+        nfa.addState(std::move(state));
     }
     
-     
-    for (const Transition& trans : final.transitions) {
-        nfa->addTransition(trans);
-         
-        for (const QString& sym : trans.getSymbols()) {
-            if (sym != "E") {
-                nfa->addToAlphabet(sym);
-            }
-        }
-    }
-    
-     
-    int col = 0, row = 0;
-    int cols = qCeil(qSqrt(final.states.size()));
-    
-    for (State& state : nfa->getStates()) {
-        state.setPosition(QPointF(100 + col * 120, 100 + row * 120));
-        col++;
-        if (col >= cols) {
-            col = 0;
-            row++;
-        }
+    for (const Edge& edge : edges) {
+        nfa.addTransition(ids[edge.from], ids[edge.to],
+                          edge.epsilon ? QString("E") : QString(edge.symbol));
     }
+    edges.clear();
     
-    return nfa;
+    return nfa.finish();
 }
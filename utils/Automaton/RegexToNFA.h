@@ -17,15 +17,39 @@ public:
      
     bool isValidRegex(const QString& regex, QString* error = nullptr);
 
+    static bool parseRepetitionBounds(const QString& regex, int& pos, int& min, int& max);
+    static bool hasConcatOperands(const QString& regex, int pos);
+
 private:
     struct NFAFragment {
-        QString startStateId;
-        QString endStateId;
-        QVector<State> states;
-        QVector<Transition> transitions;
+        int start;
+        int end;
+        int firstState;
+        int stateEnd;
+        int firstEdge;
+        int edgeEnd;
     };
-    
+
+    struct Edge {
+        int from;
+        int to;
+        QChar symbol;
+        bool epsilon;
+    };
+
+    struct RegexToken {
+        QChar symbol;
+        bool isOperator;
+        int min;
+        int max;
+
+        bool is(char c) const { return isOperator && symbol == QLatin1Char(c); }
+    };
+
+    static constexpr int REPEAT_COUNT_LIMIT = 100000;
+
     int stateCounter;
+    QVector<Edge> edges;
     
      
     NFAFragment createLiteralNFA(QChar symbol);
@@ -35,16 +59,20 @@ private:
     NFAFragment kleeneStar(NFAFragment a);
     NFAFragment kleenePlus(NFAFragment a);
     NFAFragment optional(NFAFragment a);
+    NFAFragment repeat(NFAFragment a, int min, int max);
+    NFAFragment cloneFragment(const NFAFragment& a);
+    NFAFragment makeFragment(int start, int end, int firstState, int firstEdge) const;
     
      
-    QString infixToPostfix(const QString& regex);
-    bool isOperator(QChar c);
-    int precedence(QChar op);
-    QString insertConcatOperator(const QString& regex);
+    QVector<RegexToken> tokenize(const QString& regex);
+    QVector<RegexToken> infixToPostfix(const QVector<RegexToken>& regex);
+    int precedence(const RegexToken& op);
+    QVector<RegexToken> insertConcatOperator(const QVector<RegexToken>& regex);
     
      
-    QString generateStateId();
-    void mergeFragments(NFAFragment& target, const NFAFragment& source);
+    int newState();
+    void addEdge(int from, int to, QChar symbol);
+    void addEpsilon(int from, int to);
 };
 
 #endif  
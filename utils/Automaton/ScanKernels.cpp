@@ -0,0 +1,207 @@
+#include "ScanKernels.h"
+#include <QtAlgorithms>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+enum class CharClass { Newline, Whitespace, Digit, Identifier };
+
+template <CharClass K>
+inline bool inClass(uint u) {
+    switch (K) {
+    case CharClass::Newline: return u == '\n';
+    case CharClass::Whitespace: return u == ' ' || u == '\t' || u == '\r' || u == '\n';
+    case CharClass::Digit: return u - '0' < 10;
+    case CharClass::Identifier: return u - '0' < 10 || (u | 0x20) - 'a' < 26 || u == '_';
+    }
+    return false;
+}
+
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#define SCAN_KERNELS_SIMD
+
+#if defined(__AVX2__)
+typedef __m256i Vector;
+const int VectorBytes = 32;
+const uint FullMask = 0xffffffffu;
+
+inline Vector loadVector(const void* p) { return _mm256_loadu_si256(static_cast<const __m256i*>(p)); }
+inline uint maskOf(Vector v) { return uint(_mm256_movemask_epi8(v)); }
+inline Vector orVector(Vector a, Vector b) { return _mm256_or_si256(a, b); }
+inline Vector andVector(Vector a, Vector b) { return _mm256_and_si256(a, b); }
+
+template <typename Unit>
+inline Vector splat(int c) {
+    if constexpr (sizeof(Unit) == 1) return _mm256_set1_epi8(char(c));
+    else return _mm256_set1_epi16(short(c));
+}
+
+template <typename Unit>
+inline Vector equal(Vector a, Vector b) {
+    if constexpr (sizeof(Unit) == 1) return _mm256_cmpeq_epi8(a, b);
+    else return _mm256_cmpeq_epi16(a, b);
+}
+
+template <typename Unit>
+inline Vector greater(Vector a, Vector b) {
+    if constexpr (sizeof(Unit) == 1) return _mm256_cmpgt_epi8(a, b);
+    else return _mm256_cmpgt_epi16(a, b);
+}
+#else
+typedef __m128i Vector;
+const int VectorBytes = 16;
+const uint FullMask = 0xffffu;
+
+inline Vector loadVector(const void* p) { return _mm_loadu_si128(static_cast<const __m128i*>(p)); }
+inline uint maskOf(Vector v) { return uint(_mm_movemask_epi8(v)); }
+inline Vector orVector(Vector a, Vector b) { return _mm_or_si128(a, b); }
+inline Vector andVector(Vector a, Vector b) { return _mm_and_si128(a, b); }
+
+template <typename Unit>
+inline Vector splat(int c) {
+    if constexpr (sizeof(Unit) == 1) return _mm_set1_epi8(char(c));
+    else return _mm_set1_epi16(short(c));
+}
+
+template <typename Unit>
+inline Vector equal(Vector a, Vector b) {
+    if constexpr (sizeof(Unit) == 1) return _mm_cmpeq_epi8(a, b);
+    else return _mm_cmpeq_epi16(a, b);
+}
+
+template <typename Unit>
+inline Vector greater(Vector a, Vector b) {
+    if constexpr (sizeof(Unit) == 1) return _mm_cmpgt_epi8(a, b);
+    else return _mm_cmpgt_epi16(a, b);
+}
+#endif
+
+
+template <typename Unit>
+inline Vector inRange(Vector v, int lo, int hi) {
+    return andVector(greater<Unit>(v, splat<Unit>(lo - 1)), greater<Unit>(splat<Unit>(hi + 1), v));
+}
+
+template <CharClass K, typename Unit>
+inline Vector classify(Vector v) {
+    switch (K) {
+    case CharClass::Newline:
+        return equal<Unit>(v, splat<Unit>('\n'));
+    case CharClass::Whitespace:
+        return orVector(orVector(equal<Unit>(v, splat<Unit>(' ')), equal<Unit>(v, splat<Unit>('\t'))),
+                        orVector(equal<Unit>(v, splat<Unit>('\r')), equal<Unit>(v, splat<Unit>('\n'))));
+    case CharClass::Digit:
+        return inRange<Unit>(v, '0', '9');
+    case CharClass::Identifier:
+        return orVector(orVector(inRange<Unit>(v, '0', '9'), equal<Unit>(v, splat<Unit>('_'))),
+                        inRange<Unit>(orVector(v, splat<Unit>(0x20)), 'a', 'z'));
+    }
+    return v;
+}
+#endif
+
+
+template <CharClass K, bool Member, typename Unit>
+int findFirst(const Unit* data, int from, int end) {
+    int i = from;
+#ifdef SCAN_KERNELS_SIMD
+    const int step = VectorBytes / int(sizeof(Unit));
+    for (; i + step <= end; i += step) {
+        uint mask = maskOf(classify<K, Unit>(loadVector(data + i)));
+        if (!Member) {
+            mask = ~mask & FullMask;
+        }
+        if (mask) {
+            return i + int(qCountTrailingZeroBits(mask)) / int(sizeof(Unit));
+        }
+    }
+#endif
+    for (; i < end; ++i) {
+        if (inClass<K>(data[i]) == Member) {
+            return i;
+        }
+    }
+    return end;
+}
+
+template <CharClass K, typename Unit>
+int countMembers(const Unit* data, int from, int end) {
+    int count = 0;
+    int i = from;
+#ifdef SCAN_KERNELS_SIMD
+    const int step = VectorBytes / int(sizeof(Unit));
+    for (; i + step <= end; i += step) {
+        uint mask = maskOf(classify<K, Unit>(loadVector(data + i)));
+        count += int(qPopulationCount(mask)) / int(sizeof(Unit));
+    }
+#endif
+    for (; i < end; ++i) {
+        if (inClass<K>(data[i])) {
+            count++;
+        }
+    }
+    return count;
+}
+
+inline const uchar* units(const char* data) { return reinterpret_cast<const uchar*>(data); }
+inline const ushort* units(const QChar* data) { return reinterpret_cast<const ushort*>(data); }
+
+template <typename Unit>
+QVector<int> buildLineStarts(const Unit* data, int size) {
+    QVector<int> starts;
+    starts.reserve(countMembers<CharClass::Newline>(data, 0, size) + 1);
+    starts.append(0);
+    for (int i = findFirst<CharClass::Newline, true>(data, 0, size); i < size;
+         i = findFirst<CharClass::Newline, true>(data, i + 1, size)) {
+        starts.append(i + 1);
+    }
+    return starts;
+}
+
+}
+
+int ScanKernels::skipWhitespace(const char* data, int from, int end) {
+    return findFirst<CharClass::Whitespace, false>(units(data), from, end);
+}
+
+int ScanKernels::skipWhitespace(const QChar* data, int from, int end) {
+    return findFirst<CharClass::Whitespace, false>(units(data), from, end);
+}
+
+int ScanKernels::findNewline(const char* data, int from, int end) {
+    return findFirst<CharClass::Newline, true>(units(data), from, end);
+}
+
+int ScanKernels::findNewline(const QChar* data, int from, int end) {
+    return findFirst<CharClass::Newline, true>(units(data), from, end);
+}
+
+int ScanKernels::identifierEnd(const char* data, int from, int end) {
+    return findFirst<CharClass::Identifier, false>(units(data), from, end);
+}
+
+int ScanKernels::identifierEnd(const QChar* data, int from, int end) {
+    return findFirst<CharClass::Identifier, false>(units(data), from, end);
+}
+
+int ScanKernels::digitsEnd(const char* data, int from, int end) {
+    return findFirst<CharClass::Digit, false>(units(data), from, end);
+}
+
+int ScanKernels::digitsEnd(const QChar* data, int from, int end) {
+    return findFirst<CharClass::Digit, false>(units(data), from, end);
+}
+
+QVector<int> ScanKernels::lineStarts(const char* data, int size) {
+    return buildLineStarts(units(data), size);
+}
+
+QVector<int> ScanKernels::lineStarts(const QChar* data, int size) {
+    return buildLineStarts(units(data), size);
+}
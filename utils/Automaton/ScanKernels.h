@@ -0,0 +1,21 @@
+#ifndef SCANKERNELS_H
+#define SCANKERNELS_H
+
+#include <QChar>
+#include <QVector>
+
+struct ScanKernels {
+    static int skipWhitespace(const char* data, int from, int end);
+    static int skipWhitespace(const QChar* data, int from, int end);
+    static int findNewline(const char* data, int from, int end);
+    static int findNewline(const QChar* data, int from, int end);
+    static int identifierEnd(const char* data, int from, int end);
+    static int identifierEnd(const QChar* data, int from, int end);
+    static int digitsEnd(const char* data, int from, int end);
+    static int digitsEnd(const QChar* data, int from, int end);
+
+    static QVector<int> lineStarts(const char* data, int size);
+    static QVector<int> lineStarts(const QChar* data, int size);
+};
+
+#endif
@@ -0,0 +1,599 @@
+#ifndef STATICDFA_H
+#define STATICDFA_H
+
+#include "./src/models/Automaton/Automaton.h"
+#include "./src/models/Automaton/AutomatonBuilder.h"
+#include <QChar>
+#include <QString>
+#include <QPointF>
+#include <QVector>
+#include <QSet>
+#include <cstddef>
+#include <cstdint>
+
+constexpr std::uint32_t staticCodeUnit(char c) { return static_cast<unsigned char>(c); }
+constexpr std::uint32_t staticCodeUnit(char16_t c) { return c; }
+constexpr std::uint32_t staticCodeUnit(QChar c) { return c.unicode(); }
+
+
+template <int MaxStates, int MaxClasses>
+struct StaticDFA {
+    bool valid = false;
+    int stateCount = 0;
+    int classCount = 0;
+    std::uint8_t byteClass[256] = {};
+    std::int16_t next[MaxStates][MaxClasses] = {};
+    bool accepting[MaxStates] = {};
+
+    constexpr int step(int state, std::uint32_t unit) const {
+        return (unit < 256) ? next[state][byteClass[unit]] : -1;
+    }
+
+    template <typename CharT>
+    constexpr std::ptrdiff_t longestPrefix(const CharT* s, std::size_t n) const {
+        int state = 0;
+        std::ptrdiff_t last = accepting[0] ? 0 : -1;
+        for (std::size_t i = 0; i < n; ++i) {
+            state = step(state, staticCodeUnit(s[i]));
+            if (state < 0) {
+                break;
+            }
+            if (accepting[state]) {
+                last = static_cast<std::ptrdiff_t>(i + 1);
+            }
+        }
+        return last;
+    }
+
+    template <typename CharT>
+    constexpr bool matches(const CharT* s, std::size_t n) const {
+        return longestPrefix(s, n) == static_cast<std::ptrdiff_t>(n);
+    }
+
+    int longestPrefix(const QString& text, int from = 0) const {
+        return int(longestPrefix(text.constData() + from, std::size_t(text.length() - from)));
+    }
+
+    bool matches(const QString& text) const {
+        return matches(text.constData(), std::size_t(text.length()));
+    }
+
+    Automaton toAutomaton(const QString& id, const QString& name, const QPointF& origin) const;
+};
+
+
+template <int MaxPositions>
+struct StaticRegexParser {
+    static constexpr int Words = (MaxPositions + 64) / 64;
+
+    struct Set {
+        std::uint64_t bits[Words] = {};
+
+        constexpr void set(int p) { bits[p / 64] |= std::uint64_t(1) << (p % 64); }
+        constexpr bool test(int p) const { return (bits[p / 64] >> (p % 64)) & 1; }
+
+        constexpr void unite(const Set& other) {
+            for (int w = 0; w < Words; ++w) bits[w] |= other.bits[w];
+        }
+
+        constexpr Set intersected(const Set& other) const {
+            Set result;
+            for (int w = 0; w < Words; ++w) result.bits[w] = bits[w] & other.bits[w];
+            return result;
+        }
+
+        constexpr bool isEmpty() const {
+            for (int w = 0; w < Words; ++w) {
+                if (bits[w]) return false;
+            }
+            return true;
+        }
+
+        constexpr bool equals(const Set& other) const {
+            for (int w = 0; w < Words; ++w) {
+                if (bits[w] != other.bits[w]) return false;
+            }
+            return true;
+        }
+    };
+
+    struct Frag {
+        Set first;
+        Set last;
+        bool nullable = false;
+    };
+
+    struct CharSet {
+        std::uint64_t bits[4] = {};
+
+        constexpr void add(std::uint32_t c) { bits[c / 64] |= std::uint64_t(1) << (c % 64); }
+        constexpr bool contains(std::uint32_t c) const { return (bits[c / 64] >> (c % 64)) & 1; }
+
+        constexpr void addRange(std::uint32_t lo, std::uint32_t hi) {
+            for (std::uint32_t c = lo; c <= hi; ++c) add(c);
+        }
+
+        constexpr void unite(const CharSet& other) {
+            for (int w = 0; w < 4; ++w) bits[w] |= other.bits[w];
+        }
+
+        constexpr void invert() {
+            for (int w = 0; w < 4; ++w) bits[w] = ~bits[w];
+        }
+    };
+
+    const char* pattern = nullptr;
+    int length = 0;
+    int cursor = 0;
+    bool error = false;
+    int positions = 1;
+    CharSet chars[MaxPositions + 1] = {};
+    Set follow[MaxPositions + 1] = {};
+
+    constexpr StaticRegexParser(const char* p, int n) : pattern(p), length(n) {}
+
+    constexpr bool atEnd() const { return cursor >= length; }
+    constexpr char peek() const { return pattern[cursor]; }
+
+    constexpr void link(const Set& from, const Set& to) {
+        for (int p = 0; p < positions; ++p) {
+            if (from.test(p)) follow[p].unite(to);
+        }
+    }
+
+    constexpr Frag epsilon() const {
+        Frag result;
+        result.nullable = true;
+        return result;
+    }
+
+    constexpr Frag position(const CharSet& set) {
+        if (positions > MaxPositions) {
+            error = true;
+            return epsilon();
+        }
+        int p = positions++;
+        chars[p] = set;
+        Frag result;
+        result.first.set(p);
+        result.last.set(p);
+        return result;
+    }
+
+    constexpr Frag concat(const Frag& a, const Frag& b) {
+        link(a.last, b.first);
+        Frag result;
+        result.first = a.first;
+        if (a.nullable) result.first.unite(b.first);
+        result.last = b.last;
+        if (b.nullable) result.last.unite(a.last);
+        result.nullable = a.nullable && b.nullable;
+        return result;
+    }
+
+    constexpr Frag alternate(const Frag& a, const Frag& b) const {
+        Frag result = a;
+        result.first.unite(b.first);
+        result.last.unite(b.last);
+        result.nullable = a.nullable || b.nullable;
+        return result;
+    }
+
+    constexpr Frag star(Frag a) {
+        link(a.last, a.first);
+        a.nullable = true;
+        return a;
+    }
+
+    constexpr Frag plus(Frag a) {
+        link(a.last, a.first);
+        return a;
+    }
+
+    constexpr Frag optional(Frag a) const {
+        a.nullable = true;
+        return a;
+    }
+
+    constexpr Frag parseAlternation() {
+        Frag left = parseConcatenation();
+        while (!error && !atEnd() && peek() == '|') {
+            cursor++;
+            Frag right = parseConcatenation();
+            left = alternate(left, right);
+        }
+        return left;
+    }
+
+    constexpr Frag parseConcatenation() {
+        Frag result = epsilon();
+        while (!error && !atEnd() && peek() != '|' && peek() != ')') {
+            Frag next = parseRepetition(length);
+            result = concat(result, next);
+        }
+        return result;
+    }
+
+    constexpr Frag parseRepetition(int limit) {
+        int atomStart = cursor;
+        Frag atom = parseAtom();
+
+        while (!error && cursor < limit && !atEnd()) {
+            char c = peek();
+            if (c == '*') {
+                atom = star(atom);
+                cursor++;
+            } else if (c == '+') {
+                atom = plus(atom);
+                cursor++;
+            } else if (c == '?') {
+                atom = optional(atom);
+                cursor++;
+            } else if (c == '{') {
+                int opStart = cursor;
+                int min = 0, max = 0;
+                if (!parseBounds(min, max)) {
+                    error = true;
+                    break;
+                }
+                int resume = cursor;
+                atom = repeat(atom, atomStart, opStart, min, max);
+                cursor = resume;
+            } else {
+                break;
+            }
+        }
+        return atom;
+    }
+
+    constexpr Frag reparse(int atomStart, int opStart) {
+        cursor = atomStart;
+        return parseRepetition(opStart);
+    }
+
+    constexpr Frag repeat(const Frag& atom, int atomStart, int opStart, int min, int max) {
+        if (max == 0) {
+            return epsilon();
+        }
+        if (min == 0 && max < 0) {
+            return star(atom);
+        }
+
+        int copies = (max < 0) ? min : max;
+        Frag result = (min == 0) ? optional(atom) : atom;
+        for (int i = 1; i < copies && !error; ++i) {
+            Frag part = reparse(atomStart, opStart);
+            result = concat(result, (i >= min) ? optional(part) : part);
+        }
+        if (max < 0 && !error) {
+            result = concat(result, star(reparse(atomStart, opStart)));
+        }
+        return result;
+    }
+
+    constexpr bool readNumber(int& value) {
+        int begin = cursor;
+        value = 0;
+        while (!atEnd() && peek() >= '0' && peek() <= '9' && value <= MaxPositions) {
+            value = value * 10 + (peek() - '0');
+            cursor++;
+        }
+        return cursor > begin;
+    }
+
+    constexpr bool parseBounds(int& min, int& max) {
+        cursor++;
+        if (!readNumber(min)) return false;
+        max = min;
+        if (!atEnd() && peek() == ',') {
+            cursor++;
+            if (!readNumber(max)) max = -1;
+        }
+        if (atEnd() || peek() != '}') return false;
+        cursor++;
+        return max < 0 || max >= min;
+    }
+
+    constexpr CharSet parseEscape() {
+        CharSet set;
+        if (atEnd()) {
+            error = true;
+            return set;
+        }
+
+        char e = pattern[cursor++];
+        switch (e) {
+        case 'd': set.addRange('0', '9'); break;
+        case 'w': set.addRange('a', 'z'); set.addRange('A', 'Z'); set.addRange('0', '9'); set.add('_'); break;
+        case 's': set.add(' '); set.add('\t'); set.add('\n'); set.add('\r'); set.add('\f'); set.add('\v'); break;
+        case 'n': set.add('\n'); break;
+        case 't': set.add('\t'); break;
+        case 'r': set.add('\r'); break;
+        default: set.add(staticCodeUnit(e)); break;
+        }
+        return set;
+    }
+
+    constexpr CharSet parseClass() {
+        CharSet set;
+        bool negate = false;
+        cursor++;
+        if (!atEnd() && peek() == '^') {
+            negate = true;
+            cursor++;
+        }
+
+        while (!atEnd() && peek() != ']') {
+            if (peek() == '\\') {
+                cursor++;
+                set.unite(parseEscape());
+                continue;
+            }
+
+            std::uint32_t lo = staticCodeUnit(pattern[cursor++]);
+            if (cursor + 1 < length && peek() == '-' && pattern[cursor + 1] != ']') {
+                std::uint32_t hi = staticCodeUnit(pattern[cursor + 1]);
+                cursor += 2;
+                if (hi < lo) {
+                    error = true;
+                    return set;
+                }
+                set.addRange(lo, hi);
+            } else {
+                set.add(lo);
+            }
+        }
+
+        if (atEnd()) {
+            error = true;
+            return set;
+        }
+        cursor++;
+
+        if (negate) set.invert();
+        return set;
+    }
+
+    constexpr Frag parseAtom() {
+        char c = peek();
+
+        if (c == '(') {
+            cursor++;
+            Frag inner = parseAlternation();
+            if (atEnd() || peek() != ')') {
+                error = true;
+                return inner;
+            }
+            cursor++;
+            return inner;
+        }
+
+        if (c == '*' || c == '+' || c == '?' || c == '{') {
+            error = true;
+            return epsilon();
+        }
+
+        if (c == '[') {
+            return position(parseClass());
+        }
+
+        cursor++;
+        if (c == 'E') {
+            return epsilon();
+        }
+        if (c == '\\') {
+            return position(parseEscape());
+        }
+
+        CharSet set;
+        set.add(staticCodeUnit(c));
+        return position(set);
+    }
+};
+
+
+template <int MaxStates, int MaxClasses>
+constexpr StaticDFA<MaxStates, MaxClasses> minimizeStaticDFA(const StaticDFA<MaxStates, MaxClasses>& dfa) {
+    int block[MaxStates] = {};
+    int blockCount = 0;
+    for (int s = 0; s < dfa.stateCount; ++s) {
+        block[s] = (dfa.accepting[s] == dfa.accepting[0]) ? 0 : 1;
+        blockCount = block[s] + 1 > blockCount ? block[s] + 1 : blockCount;
+    }
+
+    auto target = [&block](int state) { return state < 0 ? -1 : block[state]; };
+
+    while (true) {
+        int refined[MaxStates] = {};
+        int refinedCount = 0;
+
+        for (int s = 0; s < dfa.stateCount; ++s) {
+            refined[s] = -1;
+            for (int t = 0; t < s && refined[s] < 0; ++t) {
+                bool same = block[s] == block[t];
+                for (int c = 0; c < dfa.classCount && same; ++c) {
+                    same = target(dfa.next[s][c]) == target(dfa.next[t][c]);
+                }
+                if (same) {
+                    refined[s] = refined[t];
+                }
+            }
+            if (refined[s] < 0) {
+                refined[s] = refinedCount++;
+            }
+        }
+
+        for (int s = 0; s < dfa.stateCount; ++s) {
+            block[s] = refined[s];
+        }
+        if (refinedCount == blockCount) {
+            break;
+        }
+        blockCount = refinedCount;
+    }
+
+    StaticDFA<MaxStates, MaxClasses> minimal;
+    for (int b = 0; b < 256; ++b) {
+        minimal.byteClass[b] = dfa.byteClass[b];
+    }
+    for (int s = 0; s < dfa.stateCount; ++s) {
+        int b = block[s];
+        minimal.accepting[b] = dfa.accepting[s];
+        for (int c = 0; c < dfa.classCount; ++c) {
+            minimal.next[b][c] = std::int16_t(target(dfa.next[s][c]));
+        }
+    }
+    minimal.stateCount = blockCount;
+    minimal.classCount = dfa.classCount;
+    minimal.valid = dfa.valid;
+    return minimal;
+}
+
+
+template <int MaxStates = 16, int MaxClasses = 16, int MaxPositions = 64, std::size_t N = 1>
+constexpr StaticDFA<MaxStates, MaxClasses> compileStaticRegex(const char (&pattern)[N]) {
+    using Parser = StaticRegexParser<MaxPositions>;
+    using Set = typename Parser::Set;
+
+    StaticDFA<MaxStates, MaxClasses> dfa;
+    Parser parser(pattern, int(N) - 1);
+    if (parser.atEnd()) {
+        return dfa;
+    }
+
+    auto root = parser.parseAlternation();
+    if (parser.error || !parser.atEnd()) {
+        return dfa;
+    }
+
+    parser.follow[0] = root.first;
+    Set finals = root.last;
+    if (root.nullable) {
+        finals.set(0);
+    }
+
+
+    int classOf[256] = {};
+    int classCount = 1;
+    for (int p = 1; p < parser.positions; ++p) {
+        int remap[256][2] = {};
+        for (int c = 0; c < classCount; ++c) {
+            remap[c][0] = -1;
+            remap[c][1] = -1;
+        }
+
+        int count = 0;
+        for (int b = 0; b < 256; ++b) {
+            int bit = parser.chars[p].contains(std::uint32_t(b)) ? 1 : 0;
+            if (remap[classOf[b]][bit] < 0) {
+                remap[classOf[b]][bit] = count++;
+            }
+            classOf[b] = remap[classOf[b]][bit];
+        }
+        classCount = count;
+    }
+
+    if (classCount > MaxClasses) {
+        return dfa;
+    }
+
+    Set classPositions[MaxClasses] = {};
+    for (int c = 0; c < classCount; ++c) {
+        int representative = 0;
+        while (classOf[representative] != c) {
+            representative++;
+        }
+        for (int p = 1; p < parser.positions; ++p) {
+            if (parser.chars[p].contains(std::uint32_t(representative))) {
+                classPositions[c].set(p);
+            }
+        }
+    }
+
+
+    Set states[MaxStates] = {};
+    int stateCount = 1;
+    states[0].set(0);
+
+    for (int s = 0; s < stateCount; ++s) {
+        dfa.accepting[s] = !states[s].intersected(finals).isEmpty();
+
+        Set reach;
+        for (int p = 0; p < parser.positions; ++p) {
+            if (states[s].test(p)) {
+                reach.unite(parser.follow[p]);
+            }
+        }
+
+        for (int c = 0; c < classCount; ++c) {
+            Set target = reach.intersected(classPositions[c]);
+            if (target.isEmpty()) {
+                dfa.next[s][c] = -1;
+                continue;
+            }
+
+            int found = -1;
+            for (int t = 0; t < stateCount && found < 0; ++t) {
+                if (states[t].equals(target)) {
+                    found = t;
+                }
+            }
+
+            if (found < 0) {
+                if (stateCount == MaxStates) {
+                    return StaticDFA<MaxStates, MaxClasses>();
+                }
+                found = stateCount;
+                states[stateCount++] = target;
+            }
+            dfa.next[s][c] = std::int16_t(found);
+        }
+    }
+
+    for (int b = 0; b < 256; ++b) {
+        dfa.byteClass[b] = std::uint8_t(classOf[b]);
+    }
+    dfa.stateCount = stateCount;
+    dfa.classCount = classCount;
+    dfa.valid = true;
+    return minimizeStaticDFA(dfa);
+}
+
+
+template <int MaxStates, int MaxClasses>
+Automaton StaticDFA<MaxStates, MaxClasses>::toAutomaton(const QString& id, const QString& name,
+                                                         const QPointF& origin) const {
+    Automaton automaton(id, name, AutomatonType::DFA);
+    if (!valid) {
+        return automaton;
+    }
+
+    AutomatonBuilder builder(id, name, AutomatonType::DFA);
+    builder.reserve(stateCount, stateCount * classCount);
+
+    for (int s = 0; s < stateCount; ++s) {
+        QString stateId = QString("q%1").arg(s);
+        State state(stateId, stateId, QPointF(origin.x() + s * 100, origin.y()));
+        state.setIsInitial(s == 0);
+        state.setIsFinal(accepting[s]);
+        builder.addState(std::move(state));
+
+        for (int t = 0; t < stateCount; ++t) {
+            QSet<QString> symbols;
+            for (int u = 1; u < 256; ++u) {
+                QString symbol = QString(QChar(ushort(u)));
+                if (next[s][byteClass[u]] == t && symbol != "E") {
+                    symbols.insert(symbol);
+                }
+            }
+            if (!symbols.isEmpty()) {
+                builder.addTransition(Transition(stateId, QString("q%1").arg(t), symbols));
+            }
+        }
+    }
+
+    builder.finish(automaton);
+    return automaton;
+}
+
+#endif
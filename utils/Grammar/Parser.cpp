@@ -12,11 +12,22 @@ void Parser::setGrammar(Grammar* g) {
 }
 
 void Parser::setTokens(const QVector<Token>& toks) {
+    tokens = TokenStream(toks);
+    currentPosition = 0;
+}
+
+void Parser::setTokens(const TokenStream& toks) {
     tokens = toks;
     currentPosition = 0;
 }
 
+void Parser::setLexer(Lexer* lexer) {
+    tokens = TokenReader(lexer);
+    currentPosition = 0;
+}
+
 void Parser::reset() {
+    tokens.rewind();
     currentPosition = 0;
     errors.clear();
 }
@@ -35,7 +46,7 @@ ParseTree Parser::parse() {
 ParseTree Parser::parseExpression() {
     ParseTree tree(grammar->getName());
 
-    if (tokens.isEmpty()) {
+    if (!tokens.has(0)) {
         addError("Empty token stream", "tokens");
         return tree;
     }
@@ -172,14 +183,14 @@ std::shared_ptr<ParseTreeNode> Parser::parseF() {
 }
 
 Token Parser::peek() const {
-    if (currentPosition >= tokens.size()) {
+    if (!tokens.has(currentPosition)) {
         return Token(TokenType::END_OF_FILE, "", 0, 0);
     }
     return tokens[currentPosition];
 }
 
 Token Parser::advance() {
-    if (currentPosition >= tokens.size()) {
+    if (!tokens.has(currentPosition)) {
         return Token(TokenType::END_OF_FILE, "", 0, 0);
     }
     return tokens[currentPosition++];
@@ -194,21 +205,19 @@ bool Parser::match(const QString& expected) {
 }
 
 bool Parser::check(const QString& expected) const {
-    if (currentPosition >= tokens.size()) return false;
-
-    Token tok = peek();
+    if (!tokens.has(currentPosition)) return false;
 
      
-    if (tok.getTypeString() == expected) return true;
+    if (Token::tokenTypeToString(tokens.typeAt(currentPosition)) == expected) return true;
 
      
-    if (tok.getLexeme() == expected) return true;
+    if (tokens.lexemeAt(currentPosition) == expected) return true;
 
     return false;
 }
 
 bool Parser::isAtEnd() const {
-    return currentPosition >= tokens.size();
+    return !tokens.has(currentPosition);
 }
 
 void Parser::addError(const QString& message, const QString& expected) {
@@ -216,9 +225,10 @@ void Parser::addError(const QString& message, const QString& expected) {
 }
 
 QString Parser::getCurrentTokenString() const {
-    if (currentPosition >= tokens.size()) {
+    if (!tokens.has(currentPosition)) {
         return "EOF";
     }
-    Token tok = tokens[currentPosition];
-    return QString("%1 ('%2')").arg(tok.getTypeString()).arg(tok.getLexeme());
+    return QString("%1 ('%2')")
+        .arg(Token::tokenTypeToString(tokens.typeAt(currentPosition)))
+        .arg(tokens.lexemeAt(currentPosition).toString());
 }
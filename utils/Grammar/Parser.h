@@ -4,6 +4,8 @@
 #include "./src/models/Grammar/Grammar.h"
 #include "./src/models/Grammar/ParseTree.h"
 #include "./src/models/LexicalAnalysis/Token.h"
+#include "./src/models/LexicalAnalysis/TokenStream.h"
+#include "./src/utils/LexicalAnalysis/TokenReader.h"
 #include <QVector>
 #include <QString>
 
@@ -25,7 +27,7 @@ struct ParseError {
 class Parser {
 private:
     Grammar* grammar;
-    QVector<Token> tokens;
+    TokenReader tokens;
     int currentPosition;
     QVector<ParseError> errors;
     std::shared_ptr<ParseTreeNode> currentNode;
@@ -37,6 +39,8 @@ public:
 
     void setGrammar(Grammar* g);
     void setTokens(const QVector<Token>& toks);
+    void setTokens(const TokenStream& toks);
+    void setLexer(Lexer* lexer);
 
     ParseTree parse();
     ParseTree parseExpression();   
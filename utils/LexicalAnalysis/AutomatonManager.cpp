@@ -1,7 +1,9 @@
 #include "AutomatonManager.h"
+#include "BuiltinAutomata.h"
 #include <QDebug>
+#include <QMutexLocker>
 
-AutomatonManager::AutomatonManager() {
+AutomatonManager::AutomatonManager() : matcherDirty(true), revision(0) {
     createDefaultAutomatons();
 }
 
@@ -15,6 +17,7 @@ bool AutomatonManager::addAutomaton(const Automaton& automaton) {
     }
     idToIndex[automaton.getId()] = automatons.size();
     automatons.push_back(automaton);
+    markModified();
     return true;
 }
 
@@ -28,12 +31,16 @@ bool AutomatonManager::removeAutomaton(const QString& id) {
     for (int i = 0; i < automatons.size(); ++i) {
         idToIndex[automatons[i].getId()] = i;
     }
+    markModified();
     return true;
 }
 
 Automaton* AutomatonManager::getAutomaton(const QString& id) {
     int index = getAutomatonIndex(id);
-    return (index != -1) ? &automatons[index] : nullptr;
+    if (index == -1) return nullptr;
+
+    markModified();
+    return &automatons[index];
 }
 
 const Automaton* AutomatonManager::getAutomaton(const QString& id) const {
@@ -60,23 +67,34 @@ bool AutomatonManager::exists(const QString& id) const {
 void AutomatonManager::clear() {
     automatons.clear();
     idToIndex.clear();
+    markModified();
 }
 
-QString AutomatonManager::findMatchingAutomaton(const QString& input) const {
+// Callers must hold matcherMutex.
+void AutomatonManager::ensureMatcher() const {
+    if (!matcherDirty) return;
+
+    matcher.clear();
     for (const auto& automaton : automatons) {
-        if (automaton.accepts(input)) {
-            return automaton.getId();
-        }
+        matcher.addAutomaton(&automaton);
     }
-    return "";
+    matcher.compile();
+    matcherDirty = false;
+}
+
+QString AutomatonManager::findMatchingAutomaton(const QString& input) const {
+    QMutexLocker locker(&matcherMutex);
+    ensureMatcher();
+    int index = matcher.match(input);
+    return (index != -1) ? automatons[index].getId() : "";
 }
 
 QVector<QString> AutomatonManager::findAllMatchingAutomatons(const QString& input) const {
+    QMutexLocker locker(&matcherMutex);
+    ensureMatcher();
     QVector<QString> matches;
-    for (const auto& automaton : automatons) {
-        if (automaton.accepts(input)) {
-            matches.push_back(automaton.getId());
-        }
+    for (int index : matcher.matchAll(input)) {
+        matches.push_back(automatons[index].getId());
     }
     return matches;
 }
@@ -88,76 +106,13 @@ void AutomatonManager::createDefaultAutomatons() {
 }
 
 void AutomatonManager::createIdentifierAutomaton() {
-    Automaton automaton("IDENTIFIER", "Identifier", AutomatonType::DFA);
-
-    State s0("q0", "q0", QPointF(100, 100));
-    s0.setIsInitial(true);
-    State s1("q1", "q1", QPointF(200, 100));
-    s1.setIsFinal(true);
-
-    automaton.addState(s0);
-    automaton.addState(s1);
-
-    for (char c = 'a'; c <= 'z'; ++c) {
-        automaton.addTransition(Transition("q0", "q1", QString(c)));
-        automaton.addTransition(Transition("q1", "q1", QString(c)));
-    }
-    for (char c = 'A'; c <= 'Z'; ++c) {
-        automaton.addTransition(Transition("q0", "q1", QString(c)));
-        automaton.addTransition(Transition("q1", "q1", QString(c)));
-    }
-    automaton.addTransition(Transition("q0", "q1", "_"));
-    automaton.addTransition(Transition("q1", "q1", "_"));
-
-    for (char c = '0'; c <= '9'; ++c) {
-        automaton.addTransition(Transition("q1", "q1", QString(c)));
-    }
-
-    addAutomaton(automaton);
+    addAutomaton(BuiltinAutomata::identifier.toAutomaton("IDENTIFIER", "Identifier", QPointF(100, 100)));
 }
 
 void AutomatonManager::createIntegerAutomaton() {
-    Automaton automaton("INTEGER", "Integer", AutomatonType::DFA);
-
-    State s0("q0", "q0", QPointF(100, 200));
-    s0.setIsInitial(true);
-    State s1("q1", "q1", QPointF(200, 200));
-    s1.setIsFinal(true);
-
-    automaton.addState(s0);
-    automaton.addState(s1);
-
-    for (char c = '0'; c <= '9'; ++c) {
-        automaton.addTransition(Transition("q0", "q1", QString(c)));
-        automaton.addTransition(Transition("q1", "q1", QString(c)));
-    }
-
-    addAutomaton(automaton);
+    addAutomaton(BuiltinAutomata::integer.toAutomaton("INTEGER", "Integer", QPointF(100, 200)));
 }
 
 void AutomatonManager::createFloatAutomaton() {
-    Automaton automaton("FLOAT", "Float", AutomatonType::DFA);
-
-    State s0("q0", "q0", QPointF(100, 300));
-    s0.setIsInitial(true);
-    State s1("q1", "q1", QPointF(200, 300));
-    State s2("q2", "q2", QPointF(300, 300));
-    State s3("q3", "q3", QPointF(400, 300));
-    s3.setIsFinal(true);
-
-    automaton.addState(s0);
-    automaton.addState(s1);
-    automaton.addState(s2);
-    automaton.addState(s3);
-
-    for (char c = '0'; c <= '9'; ++c) {
-        automaton.addTransition(Transition("q0", "q1", QString(c)));
-        automaton.addTransition(Transition("q1", "q1", QString(c)));
-        automaton.addTransition(Transition("q2", "q3", QString(c)));
-        automaton.addTransition(Transition("q3", "q3", QString(c)));
-    }
-
-    automaton.addTransition(Transition("q1", "q2", "."));
-
-    addAutomaton(automaton);
+    addAutomaton(BuiltinAutomata::floating.toAutomaton("FLOAT", "Float", QPointF(100, 300)));
 }
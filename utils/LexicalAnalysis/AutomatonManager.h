@@ -2,13 +2,22 @@
 #define AUTOMATONMANAGER_H
 
 #include "./src/models/Automaton/Automaton.h"
+#include "./src/utils/Automaton/MultiPatternMatcher.h"
 #include <QVector>
 #include <QMap>
+#include <QMutex>
 
 class AutomatonManager {
 private:
     QVector<Automaton> automatons;
     QMap<QString, int> idToIndex;
+    mutable QMutex matcherMutex;
+    mutable MultiPatternMatcher matcher;
+    mutable bool matcherDirty;
+    quint64 revision;
+
+    void ensureMatcher() const;
+    void markModified() { matcherDirty = true; revision++; }
 
 public:
     AutomatonManager();
@@ -20,9 +29,10 @@ public:
     const Automaton* getAutomaton(const QString& id) const;
     int getAutomatonIndex(const QString& id) const;
 
-    QVector<Automaton>& getAutomatons() { return automatons; }
+    QVector<Automaton>& getAutomatons() { markModified(); return automatons; }
     const QVector<Automaton>& getAutomatons() const { return automatons; }
     int getCount() const { return automatons.size(); }
+    quint64 getRevision() const { return revision; }
     void clear();
 
     QVector<QString> getAllIds() const;
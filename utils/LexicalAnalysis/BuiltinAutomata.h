@@ -0,0 +1,32 @@
+#ifndef BUILTINAUTOMATA_H
+#define BUILTINAUTOMATA_H
+
+#include "./src/utils/Automaton/StaticDFA.h"
+
+struct BuiltinAutomata {
+    static constexpr auto identifier = compileStaticRegex("[A-Za-z_][A-Za-z0-9_]*");
+    static constexpr auto integer = compileStaticRegex("[0-9]+");
+    static constexpr auto floating = compileStaticRegex("[0-9]+\\.[0-9]+");
+    static constexpr auto utf8Identifier = compileStaticRegex<32>(
+        "([A-Za-z_]|[\xC3-\xDF][\x80-\xBF]|[\xE0-\xEF][\x80-\xBF]{2}|[\xF0-\xF4][\x80-\xBF]{3})"
+        "([A-Za-z0-9_]|[\xC3-\xDF][\x80-\xBF]|[\xE0-\xEF][\x80-\xBF]{2}|[\xF0-\xF4][\x80-\xBF]{3})*");
+};
+
+static_assert(BuiltinAutomata::identifier.valid && BuiltinAutomata::identifier.stateCount == 2,
+              "identifier automaton failed to compile");
+static_assert(BuiltinAutomata::integer.valid && BuiltinAutomata::integer.stateCount == 2,
+              "integer automaton failed to compile");
+static_assert(BuiltinAutomata::floating.valid && BuiltinAutomata::floating.stateCount == 4,
+              "float automaton failed to compile");
+static_assert(BuiltinAutomata::utf8Identifier.valid, "UTF-8 identifier automaton failed to compile");
+
+static_assert(BuiltinAutomata::identifier.matches("_count1", 7), "identifier automaton is wrong");
+static_assert(!BuiltinAutomata::identifier.matches("1count", 6), "identifier automaton is wrong");
+static_assert(BuiltinAutomata::floating.longestPrefix("3.14.", std::size_t(5)) == 4, "float automaton is wrong");
+static_assert(BuiltinAutomata::utf8Identifier.matches("caf\xC3\xA9_1", 7), "UTF-8 identifier automaton is wrong");
+static_assert(BuiltinAutomata::utf8Identifier.longestPrefix("\xCE\xB1+", std::size_t(3)) == 2, "UTF-8 identifier automaton is wrong");
+static_assert(BuiltinAutomata::utf8Identifier.longestPrefix("x\xC3\xA9\x80\x80", std::size_t(5)) == 3, "UTF-8 identifier automaton is wrong");
+static_assert(BuiltinAutomata::utf8Identifier.matches("\xE4\xB8\xAD\xF0\x9D\x9B\xBC", std::size_t(7)), "UTF-8 identifier automaton is wrong");
+static_assert(!BuiltinAutomata::utf8Identifier.matches("\xC2\xA0", std::size_t(2)), "UTF-8 identifier automaton is wrong");
+
+#endif
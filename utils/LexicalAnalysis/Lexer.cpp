@@ -1,264 +1,373 @@
 #include "Lexer.h"
+#include "./src/utils/Automaton/ScanKernels.h"
 #include <QDebug>
+#include <QFile>
+#include <QThreadPool>
+#include <limits>
 
 Lexer::Lexer()
-    : position(0), line(1), column(1), automatonManager(nullptr),
-    skipWhitespace(true), skipComments(true) {}
+    : utf8(nullptr), inputLength(0), position(0), finished(true), automatonManager(nullptr),
+    rulesRevision(0), rulesDirty(true), skipWhitespace(true), skipComments(true), threadCount(0) {}
 
 Lexer::Lexer(AutomatonManager* manager)
-    : position(0), line(1), column(1), automatonManager(manager),
-    skipWhitespace(true), skipComments(true) {}
+    : utf8(nullptr), inputLength(0), position(0), finished(true), automatonManager(manager),
+    rulesRevision(0), rulesDirty(true), skipWhitespace(true), skipComments(true), threadCount(0) {}
 
 Lexer::~Lexer() {}
 
 void Lexer::setAutomatonManager(AutomatonManager* manager) {
     automatonManager = manager;
+    rulesDirty = true;
+}
+
+void Lexer::ensureRules() {
+    quint64 revision = automatonManager ? automatonManager->getRevision() : 0;
+    if (!rulesDirty && revision == rulesRevision) return;
+
+    rules.compile(automatonManager);
+    rulesRevision = revision;
+    rulesDirty = false;
 }
 
 bool Lexer::tokenize(const QString& sourceCode) {
+    start(sourceCode);
+    return run();
+}
+
+bool Lexer::tokenizeUtf8(const char* bytes, int size, std::shared_ptr<const void> owner) {
+    startUtf8(bytes, size, std::move(owner));
+    return run();
+}
+
+bool Lexer::tokenizeFile(const QString& fileName) {
+    return startFile(fileName) && run();
+}
+
+void Lexer::start(const QString& sourceCode) {
     reset();
+    ensureRules();
     input = sourceCode;
+    inputLength = input.length();
+    source = QSharedPointer<const TokenSource>(new TokenSource(input, rules.getRuleIds(),
+                                                               ScanKernels::lineStarts(input.constData(), inputLength)));
+    tokens = TokenStream(source);
+    finished = false;
+}
 
-    while (!isAtEnd()) {
-        Token token = scanToken();
+void Lexer::startUtf8(const char* bytes, int size, std::shared_ptr<const void> owner) {
+    reset();
+    ensureRules();
+    source = QSharedPointer<const TokenSource>(new TokenSource(bytes, size, rules.getRuleIds(), std::move(owner),
+                                                               ScanKernels::lineStarts(bytes, size)));
+    utf8 = source->getUtf8().constData();
+    inputLength = size;
+    tokens = TokenStream(source);
+    finished = false;
+}
+
+bool Lexer::startFile(const QString& fileName) {
+    std::shared_ptr<QFile> file = std::make_shared<QFile>(fileName);
+    if (!file->open(QIODevice::ReadOnly)) {
+        reset();
+        addError(QString("Could not open %1: %2").arg(fileName).arg(file->errorString()));
+        return false;
+    }
+
+    qint64 size = file->size();
+    if (size > std::numeric_limits<int>::max()) {
+        reset();
+        addError(QString("%1 is too large to tokenize").arg(fileName));
+        return false;
+    }
+    if (size == 0) {
+        startUtf8("", 0);
+        return true;
+    }
+
+    uchar* mapped = file->map(0, size);
+    if (!mapped) {
+        reset();
+        addError(QString("Could not map %1: %2").arg(fileName).arg(file->errorString()));
+        return false;
+    }
+
+    std::shared_ptr<const uchar> mapping(mapped, [file](const uchar* data) {
+        file->unmap(const_cast<uchar*>(data));
+    });
+    startUtf8(reinterpret_cast<const char*>(mapped), int(size), mapping);
+    return true;
+}
+
+void Lexer::rewind() {
+    position = 0;
+    finished = !source;
+    tokens = TokenStream(source);
+    errors.clear();
+}
+
+bool Lexer::run() {
+    if (threadCount > 1 && inputLength >= 2 * MIN_CHUNK_SIZE) {
+        return runParallel(threadCount);
+    }
+
+    Token token;
+    while (next(token)) {
+        tokens.append(token);
+    }
+    return !hasErrors();
+}
+
+bool Lexer::runParallel(int threads) {
+    int count = qMin(threads * CHUNKS_PER_THREAD, inputLength / MIN_CHUNK_SIZE);
+    QVector<Chunk> chunks;
+    int begin = 0;
+    for (int i = 1; i <= count && begin < inputLength; ++i) {
+        int end = inputLength;
+        if (i < count) {
+            int target = qMax(begin, int(qint64(inputLength) * i / count));
+            end = utf8 ? ScanKernels::findNewline(utf8, target, inputLength)
+                       : ScanKernels::findNewline(input.constData(), target, inputLength);
+            end = qMin(end + 1, inputLength);
+        }
+        chunks.append(Chunk(begin, end));
+        begin = end;
+    }
+
+    {
+        QThreadPool pool;
+        pool.setMaxThreadCount(threads);
+        for (int i = 0; i < chunks.size(); ++i) {
+            Chunk* chunk = &chunks[i];
+            pool.start([this, chunk]() { lexChunk(*chunk, chunk->begin); });
+        }
+        pool.waitForDone();
+    }
+
+    // Each chunk assumed it starts on a token boundary; re-lex the ones whose
+    // predecessor actually stopped somewhere else.
+    int exit = 0;
+    int total = 1;
+    for (int i = 0; i < chunks.size(); ++i) {
+        if (i > 0 && (chunks[i].entry != exit || exit >= inputLength)) {
+            lexChunk(chunks[i], exit);
+        }
+        exit = chunks[i].exit;
+        total += chunks[i].tokens.size();
+    }
 
+    tokens.reserve(total);
+    for (const Chunk& chunk : chunks) {
+        tokens.append(chunk.tokens);
+        errors += chunk.errors;
+    }
+
+    position = inputLength;
+    tokens.append(makeToken(TokenType::END_OF_FILE, position));
+    finished = true;
+    return !hasErrors();
+}
+
+void Lexer::lexChunk(Chunk& chunk, int from) const {
+    Lexer worker(*this);
+    // A non-owning handle keeps workers off the source's shared reference count;
+    // this lexer holds the real one until every chunk is merged.
+    worker.source = QSharedPointer<const TokenSource>(source.data(), [](const TokenSource*) {});
+    worker.errors.clear();
+    worker.position = from;
+
+    chunk.tokens = TokenStream(worker.source);
+    chunk.entry = worker.lexRange(chunk.end, chunk.tokens);
+    chunk.exit = worker.position;
+    chunk.errors = worker.errors;
+}
+
+int Lexer::lexRange(int end, TokenStream& out) {
+    int entry = -1;
+    while (true) {
+        int head = position;
+        skipWhitespaceChars();
+        if (entry < 0) entry = position;
+
+        if (isAtEnd()) {
+            if (position > head) out.append(makeToken(TokenType::END_OF_FILE, position));
+            break;
+        }
+        if (position >= end) break;
+
+        Token token = scanToken();
         if (token.getType() == TokenType::WHITESPACE && skipWhitespace) continue;
         if (token.getType() == TokenType::COMMENT && skipComments) continue;
         if (token.getType() != TokenType::UNKNOWN) {
-            tokens.push_back(token);
+            out.append(token);
         }
     }
+    return entry;
+}
 
-    tokens.push_back(Token(TokenType::END_OF_FILE, "", line, column));
-    return !hasErrors();
+bool Lexer::next(Token& token) {
+    if (finished) return false;
+
+    while (!isAtEnd()) {
+        token = scanToken();
+
+        if (token.getType() == TokenType::WHITESPACE && skipWhitespace) continue;
+        if (token.getType() == TokenType::COMMENT && skipComments) continue;
+        if (token.getType() != TokenType::UNKNOWN) return true;
+    }
+
+    token = makeToken(TokenType::END_OF_FILE, position);
+    finished = true;
+    return true;
 }
 
 void Lexer::reset() {
     input.clear();
+    utf8 = nullptr;
+    inputLength = 0;
+    source.clear();
     position = 0;
-    line = 1;
-    column = 1;
+    finished = true;
     tokens.clear();
     errors.clear();
 }
 
+Token Lexer::makeToken(TokenType type, int start, int ruleId) const {
+    return Token(type, source, start, position - start, ruleId);
+}
+
 char Lexer::peek() const {
-    return isAtEnd() ? '\0' : input[position].toLatin1();
+    if (isAtEnd()) return '\0';
+    return utf8 ? utf8[position] : input[position].toLatin1();
 }
 
 char Lexer::peekNext() const {
-    return (position + 1 >= input.length()) ? '\0' : input[position + 1].toLatin1();
+    if (position + 1 >= inputLength) return '\0';
+    return utf8 ? utf8[position + 1] : input[position + 1].toLatin1();
 }
 
 char Lexer::advance() {
     if (isAtEnd()) return '\0';
-    char c = input[position].toLatin1();
+    char c = peek();
     position++;
-    column++;
-    if (c == '\n') {
-        line++;
-        column = 1;
-    }
     return c;
 }
 
+void Lexer::skipContinuationBytes() {
+    while (utf8 && !isAtEnd() && (uchar(utf8[position]) & 0xc0) == 0x80) {
+        position++;
+    }
+}
+
+void Lexer::advanceBy(int length) {
+    position += length;
+}
+
 bool Lexer::isAtEnd() const {
-    return position >= input.length();
+    return position >= inputLength;
 }
 
 Token Lexer::scanToken() {
     skipWhitespaceChars();
-    if (isAtEnd()) return Token(TokenType::END_OF_FILE, "", line, column);
+    if (isAtEnd()) return makeToken(TokenType::END_OF_FILE, position);
 
-    int startLine = line;
-    int startColumn = column;
+    int start = position;
     char c = peek();
 
     if (c == '/' && peekNext() == '/') return recognizeComment();
     if (c == '"') return recognizeString();
     if (c == '\'') return recognizeChar();
-    if (isDigit(c)) return recognizeNumber();
-    if (isAlpha(c) || c == '_') return recognizeIdentifierOrKeyword();
 
-    Token opToken = recognizeOperator();
-    if (opToken.getType() != TokenType::UNKNOWN) return opToken;
-
-    if (automatonManager) {
-        Token autoToken = recognizeWithAutomaton();
-        if (autoToken.getType() != TokenType::UNKNOWN) return autoToken;
-    }
+    Token ruleToken = recognizeWithRules();
+    if (ruleToken.getLength() > 0) return ruleToken;
 
-    QString lexeme = QString(c);
     advance();
-    addError("Unexpected character", lexeme);
-    return Token(TokenType::UNKNOWN, lexeme, startLine, startColumn);
-}
-
-Token Lexer::recognizeWithAutomaton() {
-    int startPos = position;
-    int startLine = line;
-    int startColumn = column;
-
-    QString longestMatch;
-    QString matchingAutomatonId;
-    int longestMatchEnd = position;
-
-    for (int end = position + 1; end <= input.length(); ++end) {
-        QString substring = input.mid(position, end - position);
-        if (automatonManager) {
-            QString automatonId = automatonManager->findMatchingAutomaton(substring);
-            if (!automatonId.isEmpty()) {
-                longestMatch = substring;
-                matchingAutomatonId = automatonId;
-                longestMatchEnd = end;
-            }
-        }
-    }
-
-    if (!longestMatch.isEmpty()) {
-        while (position < longestMatchEnd) advance();
-
-        TokenType type = TokenType::UNKNOWN;
-        if (matchingAutomatonId == "IDENTIFIER") {
-            type = Token::getKeywordType(longestMatch);
-        } else if (matchingAutomatonId == "INTEGER") {
-            type = TokenType::INTEGER_LITERAL;
-        } else if (matchingAutomatonId == "FLOAT") {
-            type = TokenType::FLOAT_LITERAL;
-        }
-
-        return Token(type, longestMatch, startLine, startColumn, matchingAutomatonId);
-    }
-
-    return Token(TokenType::UNKNOWN, "", startLine, startColumn);
+    skipContinuationBytes();
+    addError("Unexpected character", text(start, position - start));
+    return makeToken(TokenType::UNKNOWN, start);
 }
 
-Token Lexer::recognizeNumber() {
-    int startLine = line;
-    int startColumn = column;
-    QString number;
-    bool isFloat = false;
+Token Lexer::recognizeWithRules() {
+    int start = position;
 
-    while (isDigit(peek())) number += advance();
+    PatternMatch match = utf8 ? rules.longestMatchAt(utf8, inputLength, position)
+                              : rules.longestMatchAt(input, position);
+    if (!match.isValid() || match.length == 0) {
+        return makeToken(TokenType::UNKNOWN, start);
+    }
 
-    if (peek() == '.' && isDigit(peekNext())) {
-        isFloat = true;
-        number += advance();
-        while (isDigit(peek())) number += advance();
+    TokenType type = rules.getRule(match.patternId).type;
+    if (type == TokenType::IDENTIFIER) {
+        type = utf8 ? Token::getKeywordType(utf8 + start, match.length)
+                    : Token::getKeywordType(input.constData() + start, match.length);
     }
 
-    TokenType type = isFloat ? TokenType::FLOAT_LITERAL : TokenType::INTEGER_LITERAL;
-    QString automatonId = isFloat ? "FLOAT" : "INTEGER";
-    return Token(type, number, startLine, startColumn, automatonId);
+    advanceBy(match.length);
+    return makeToken(type, start, match.patternId);
 }
 
 Token Lexer::recognizeString() {
-    int startLine = line;
-    int startColumn = column;
-    QString str;
-    str += advance();
+    int start = position;
+    advance();
 
     while (!isAtEnd() && peek() != '"') {
         if (peek() == '\n') {
-            addError("Unterminated string literal", str);
-            return Token(TokenType::UNKNOWN, str, startLine, startColumn);
+            addError("Unterminated string literal", text(start, position - start));
+            return makeToken(TokenType::UNKNOWN, start);
         }
         if (peek() == '\\') {
-            str += advance();
-            if (!isAtEnd()) str += advance();
+            advance();
+            if (!isAtEnd()) advance();
         } else {
-            str += advance();
+            advance();
         }
     }
 
     if (isAtEnd()) {
-        addError("Unterminated string literal", str);
-        return Token(TokenType::UNKNOWN, str, startLine, startColumn);
+        addError("Unterminated string literal", text(start, position - start));
+        return makeToken(TokenType::UNKNOWN, start);
     }
 
-    str += advance();
-    return Token(TokenType::STRING_LITERAL, str, startLine, startColumn);
+    advance();
+    return makeToken(TokenType::STRING_LITERAL, start);
 }
 
 Token Lexer::recognizeChar() {
-    int startLine = line;
-    int startColumn = column;
-    QString ch;
-    ch += advance();
+    int start = position;
+    advance();
 
     if (isAtEnd() || peek() == '\'') {
-        addError("Empty character literal", ch);
-        return Token(TokenType::UNKNOWN, ch, startLine, startColumn);
+        addError("Empty character literal", text(start, position - start));
+        return makeToken(TokenType::UNKNOWN, start);
     }
 
     if (peek() == '\\') {
-        ch += advance();
-        if (!isAtEnd()) ch += advance();
-    } else {
-        ch += advance();
-    }
-
-    if (peek() != '\'') {
-        addError("Unterminated character literal", ch);
-        return Token(TokenType::UNKNOWN, ch, startLine, startColumn);
-    }
-
-    ch += advance();
-    return Token(TokenType::CHAR_LITERAL, ch, startLine, startColumn);
-}
-
-Token Lexer::recognizeIdentifierOrKeyword() {
-    int startLine = line;
-    int startColumn = column;
-    QString identifier;
-
-    while (isAlphaNumeric(peek()) || peek() == '_') {
-        identifier += advance();
-    }
-
-    TokenType type = Token::getKeywordType(identifier);
-    return Token(type, identifier, startLine, startColumn, "IDENTIFIER");
-}
-
-Token Lexer::recognizeOperator() {
-    int startLine = line;
-    int startColumn = column;
-    char c = peek();
-    char next = peekNext();
-
-    QString twoChar = QString(c) + QString(next);
-    TokenType twoCharType = Token::getOperatorType(twoChar);
-
-    if (twoCharType != TokenType::UNKNOWN) {
         advance();
+        if (!isAtEnd()) advance();
+    } else {
         advance();
-        return Token(twoCharType, twoChar, startLine, startColumn);
+        skipContinuationBytes();
     }
 
-    QString oneChar = QString(c);
-    TokenType oneCharType = Token::getOperatorType(oneChar);
-
-    if (oneCharType != TokenType::UNKNOWN) {
-        advance();
-        return Token(oneCharType, oneChar, startLine, startColumn);
+    if (peek() != '\'') {
+        addError("Unterminated character literal", text(start, position - start));
+        return makeToken(TokenType::UNKNOWN, start);
     }
 
-    return Token(TokenType::UNKNOWN, "", startLine, startColumn);
+    advance();
+    return makeToken(TokenType::CHAR_LITERAL, start);
 }
 
 Token Lexer::recognizeComment() {
-    int startLine = line;
-    int startColumn = column;
-    QString comment;
+    int start = position;
 
-    comment += advance();
-    comment += advance();
+    advance();
+    advance();
 
-    while (!isAtEnd() && peek() != '\n') {
-        comment += advance();
-    }
+    int end = utf8 ? ScanKernels::findNewline(utf8, position, inputLength)
+                   : ScanKernels::findNewline(input.constData(), position, inputLength);
+    advanceBy(end - position);
 
-    return Token(TokenType::COMMENT, comment, startLine, startColumn);
+    return makeToken(TokenType::COMMENT, start);
 }
 
 bool Lexer::isDigit(char c) const {
@@ -278,19 +387,21 @@ bool Lexer::isWhitespace(char c) const {
 }
 
 void Lexer::skipWhitespaceChars() {
-    while (!isAtEnd() && isWhitespace(peek())) {
-        advance();
-    }
+    int end = utf8 ? ScanKernels::skipWhitespace(utf8, position, inputLength)
+                   : ScanKernels::skipWhitespace(input.constData(), position, inputLength);
+    advanceBy(end - position);
 }
 
 void Lexer::addError(const QString& message, const QString& lexeme) {
+    int line = source ? source->lineOf(position) : 1;
+    int column = source ? source->columnOf(position) : 1;
     errors.push_back(LexerError(message, line, column, lexeme));
 }
 
 QString Lexer::getTokensString() const {
     QString result;
-    for (const auto& token : tokens) {
-        result += token.toString() + "\n";
+    for (int i = 0; i < tokens.size(); ++i) {
+        result += tokens.at(i).toString() + "\n";
     }
     return result;
 }
@@ -2,9 +2,12 @@
 #define LEXER_H
 
 #include "./src/models/LexicalAnalysis/Token.h"
+#include "./src/models/LexicalAnalysis/TokenStream.h"
 #include "./src/utils/LexicalAnalysis/AutomatonManager.h"
+#include "./src/utils/LexicalAnalysis/LexerRules.h"
 #include <QString>
 #include <QVector>
+#include <memory>
 
 struct LexerError {
     QString message;
@@ -23,15 +26,35 @@ struct LexerError {
 
 class Lexer {
 private:
+    struct Chunk {
+        int begin;
+        int end;
+        int entry;
+        int exit;
+        TokenStream tokens;
+        QVector<LexerError> errors;
+
+        Chunk(int b = 0, int e = 0) : begin(b), end(e), entry(b), exit(b) {}
+    };
+
+    static constexpr int MIN_CHUNK_SIZE = 1 << 20;
+    static constexpr int CHUNKS_PER_THREAD = 4;
+
     QString input;
+    const char* utf8;
+    int inputLength;
     int position;
-    int line;
-    int column;
-    QVector<Token> tokens;
+    bool finished;
+    TokenStream tokens;
+    QSharedPointer<const TokenSource> source;
     QVector<LexerError> errors;
     AutomatonManager* automatonManager;
+    LexerRules rules;
+    quint64 rulesRevision;
+    bool rulesDirty;
     bool skipWhitespace;
     bool skipComments;
+    int threadCount;
 
 public:
     Lexer();
@@ -41,9 +64,22 @@ public:
     void setAutomatonManager(AutomatonManager* manager);
     void setSkipWhitespace(bool skip) { skipWhitespace = skip; }
     void setSkipComments(bool skip) { skipComments = skip; }
+    void setThreadCount(int threads) { threadCount = threads; }
 
     bool tokenize(const QString& sourceCode);
-    QVector<Token> getTokens() const { return tokens; }
+    bool tokenizeUtf8(const char* bytes, int size, std::shared_ptr<const void> owner = std::shared_ptr<const void>());
+    bool tokenizeFile(const QString& fileName);
+
+    void start(const QString& sourceCode);
+    void startUtf8(const char* bytes, int size, std::shared_ptr<const void> owner = std::shared_ptr<const void>());
+    bool startFile(const QString& fileName);
+    void rewind();
+    bool next(Token& token);
+    bool isFinished() const { return finished; }
+
+    const QSharedPointer<const TokenSource>& getSource() const { return source; }
+    QVector<Token> getTokens() const { return tokens.toTokens(); }
+    const TokenStream& getTokenStream() const { return tokens; }
     QVector<LexerError> getErrors() const { return errors; }
     bool hasErrors() const { return !errors.isEmpty(); }
 
@@ -55,15 +91,19 @@ private:
     char peek() const;
     char peekNext() const;
     char advance();
+    void advanceBy(int length);
+    void skipContinuationBytes();
     bool isAtEnd() const;
 
+    bool run();
+    bool runParallel(int threads);
+    void lexChunk(Chunk& chunk, int from) const;
+    int lexRange(int end, TokenStream& out);
     Token scanToken();
-    Token recognizeWithAutomaton();
-    Token recognizeNumber();
+    Token makeToken(TokenType type, int start, int ruleId = -1) const;
+    Token recognizeWithRules();
     Token recognizeString();
     Token recognizeChar();
-    Token recognizeIdentifierOrKeyword();
-    Token recognizeOperator();
     Token recognizeComment();
 
     bool isDigit(char c) const;
@@ -71,8 +111,10 @@ private:
     bool isAlphaNumeric(char c) const;
     bool isWhitespace(char c) const;
 
+    QString text(int start, int length) const { return source->lexeme(start, length); }
     void addError(const QString& message, const QString& lexeme = "");
     void skipWhitespaceChars();
+    void ensureRules();
 };
 
 #endif  
@@ -0,0 +1,73 @@
+#include "LexerRules.h"
+#include "AutomatonManager.h"
+#include "BuiltinAutomata.h"
+
+static const char* const OPERATORS[] = {
+    "==", "!=", "<=", ">=", "&&", "||",
+    "+", "-", "*", "/", "%", "=", "<", ">", "!", "&", "|", "^", "~",
+    ";", ",", ".", ":", "(", ")", "{", "}", "[", "]"
+};
+
+LexerRules::LexerRules() : identifierRule(-1) {}
+
+bool LexerRules::compile(const AutomatonManager* manager) {
+    matcher.clear();
+    rules.clear();
+
+    for (const char* op : OPERATORS) {
+        QString literal = QString::fromLatin1(op);
+        matcher.addLiteral(literal);
+        rules.append(LexerRule(Token::getOperatorType(literal)));
+    }
+
+    matcher.addStaticDFA(BuiltinAutomata::floating);
+    rules.append(LexerRule(TokenType::FLOAT_LITERAL, "FLOAT"));
+    matcher.addStaticDFA(BuiltinAutomata::integer);
+    rules.append(LexerRule(TokenType::INTEGER_LITERAL, "INTEGER"));
+    identifierRule = matcher.addStaticDFA(BuiltinAutomata::identifier);
+    rules.append(LexerRule(TokenType::IDENTIFIER, "IDENTIFIER"));
+
+    if (manager) {
+        for (const auto& automaton : manager->getAutomatons()) {
+            // The manager's default IDENTIFIER/INTEGER/FLOAT automata are
+            // already covered by the static copies above.
+            if (typeForAutomaton(automaton.getId()) != TokenType::AUTOMATON) {
+                continue;
+            }
+            matcher.addAutomaton(&automaton);
+            rules.append(LexerRule(TokenType::AUTOMATON, automaton.getId()));
+        }
+    }
+
+    return matcher.compile();
+}
+
+PatternMatch LexerRules::longestMatchAt(const char* utf8, int size, int position) const {
+    PatternMatch match = matcher.longestMatchAt(utf8, size, position);
+
+    int identifier = int(BuiltinAutomata::utf8Identifier.longestPrefix(utf8 + position, size_t(size - position)));
+    if (identifier > match.length) {
+        return PatternMatch(position, identifier, identifierRule);
+    }
+    return match;
+}
+
+QVector<QString> LexerRules::getRuleIds() const {
+    QVector<QString> ids;
+    ids.reserve(rules.size());
+    for (const auto& rule : rules) {
+        ids.append(rule.automatonId);
+    }
+    return ids;
+}
+
+TokenType LexerRules::typeForAutomaton(const QString& automatonId) {
+    if (automatonId == "IDENTIFIER") {
+        return TokenType::IDENTIFIER;
+    } else if (automatonId == "INTEGER") {
+        return TokenType::INTEGER_LITERAL;
+    } else if (automatonId == "FLOAT") {
+        return TokenType::FLOAT_LITERAL;
+    }
+    return TokenType::AUTOMATON;
+}
@@ -0,0 +1,44 @@
+#ifndef LEXERRULES_H
+#define LEXERRULES_H
+
+#include "./src/models/LexicalAnalysis/Token.h"
+#include "./src/utils/Automaton/MultiPatternMatcher.h"
+#include <QString>
+#include <QVector>
+
+class AutomatonManager;
+
+struct LexerRule {
+    TokenType type;
+    QString automatonId;
+
+    LexerRule(TokenType t = TokenType::UNKNOWN, const QString& id = "")
+        : type(t), automatonId(id) {}
+};
+
+
+class LexerRules {
+public:
+    LexerRules();
+
+    bool compile(const AutomatonManager* manager = nullptr);
+    bool isCompiled() const { return matcher.isCompiled(); }
+    int getRuleCount() const { return rules.size(); }
+    const LexerRule& getRule(int rule) const { return rules[rule]; }
+    QVector<QString> getRuleIds() const;
+    const CompiledDFA& getCompiledDFA() const { return matcher.getCompiledDFA(); }
+
+    PatternMatch longestMatchAt(const QString& input, int position) const {
+        return matcher.longestMatchAt(input, position);
+    }
+    PatternMatch longestMatchAt(const char* utf8, int size, int position) const;
+
+private:
+    MultiPatternMatcher matcher;
+    QVector<LexerRule> rules;
+    int identifierRule;
+
+    static TokenType typeForAutomaton(const QString& automatonId);
+};
+
+#endif
@@ -0,0 +1,44 @@
+#include "TokenReader.h"
+
+TokenReader::TokenReader() : base(0), lexer(nullptr) {}
+
+TokenReader::TokenReader(const TokenStream& tokens) : window(tokens), base(0), lexer(nullptr) {}
+
+TokenReader::TokenReader(Lexer* lexer) : base(0), lexer(lexer) {
+    // Without a source every token would be stored detached, and discard()
+    // never frees those, so the lexer must have been started first.
+    Q_ASSERT(!lexer || lexer->getSource());
+    if (lexer && !lexer->getSource()) {
+        this->lexer = nullptr;
+    }
+    if (this->lexer) {
+        window = TokenStream(lexer->getSource());
+        window.reserve(CAPACITY);
+    }
+}
+
+void TokenReader::rewind() {
+    if (!lexer || base == 0) return;
+
+    lexer->rewind();
+    window = TokenStream(lexer->getSource());
+    window.reserve(CAPACITY);
+    base = 0;
+}
+
+bool TokenReader::fill(int index) const {
+    if (!lexer || lexer->getSource() != window.getSource()) return false;
+
+    Token token;
+    while (index - base >= window.size() && lexer->next(token)) {
+        if (window.size() >= CAPACITY) {
+            int consumed = qMin(index - LOOKBEHIND - base, window.size());
+            if (consumed > 0) {
+                window.discard(consumed);
+                base += consumed;
+            }
+        }
+        window.append(token);
+    }
+    return index - base < window.size();
+}
@@ -0,0 +1,39 @@
+#ifndef TOKENREADER_H
+#define TOKENREADER_H
+
+#include "./src/models/LexicalAnalysis/TokenStream.h"
+#include "./src/utils/LexicalAnalysis/Lexer.h"
+#include <QAnyStringView>
+#include <QtGlobal>
+
+class TokenReader {
+private:
+    mutable TokenStream window;
+    mutable int base;
+    Lexer* lexer;
+
+    bool fill(int index) const;
+
+public:
+    static constexpr int LOOKBEHIND = 16;
+    static constexpr int CAPACITY = 256;
+
+    TokenReader();
+    TokenReader(const TokenStream& tokens);
+    explicit TokenReader(Lexer* lexer);
+
+    bool isStreaming() const { return lexer != nullptr; }
+    bool has(int index) const {
+        Q_ASSERT(index >= base);
+        return index >= base && (index - base < window.size() || fill(index));
+    }
+    void rewind();
+
+    TokenType typeAt(int index) const { return window.typeAt(index - base); }
+    QAnyStringView lexemeAt(int index) const { return window.lexemeAt(index - base); }
+    int lineAt(int index) const { return window.lineAt(index - base); }
+    Token at(int index) const { return window.at(index - base); }
+    Token operator[](int index) const { return at(index); }
+};
+
+#endif
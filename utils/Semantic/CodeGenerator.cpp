@@ -13,6 +13,12 @@ CodeGenerator::CodeGenerator()
 CodeGenerator::~CodeGenerator() {}
 
 void CodeGenerator::setTokens(const QVector<Token>& toks) {
+    tokens = TokenStream(toks);
+    currentPosition = 0;
+    optimizeTokens();
+}
+
+void CodeGenerator::setTokens(const TokenStream& toks) {
     tokens = toks;
     currentPosition = 0;
     optimizeTokens();
@@ -66,17 +72,18 @@ QString CodeGenerator::generate() {
 void CodeGenerator::optimizeTokens() {
     if (tokens.isEmpty()) return;
 
-    QVector<Token> optimized;
+    TokenStream optimized(tokens.getSource());
+    optimized.reserve(tokens.size());
     bool changesMade = false;
 
     for (int i = 0; i < tokens.size(); ++i) {
         if (i + 2 < tokens.size() &&
-            tokens[i].getType() == TokenType::INTEGER_LITERAL &&
-            tokens[i+1].getType() == TokenType::PLUS &&
-            tokens[i+2].getType() == TokenType::INTEGER_LITERAL) {
+            tokens.typeAt(i) == TokenType::INTEGER_LITERAL &&
+            tokens.typeAt(i+1) == TokenType::PLUS &&
+            tokens.typeAt(i+2) == TokenType::INTEGER_LITERAL) {
 
-            int v1 = tokens[i].getLexeme().toInt();
-            int v2 = tokens[i+2].getLexeme().toInt();
+            int v1 = tokens.lexemeAt(i).toString().toInt();
+            int v2 = tokens.lexemeAt(i+2).toString().toInt();
             int sum = v1 + v2;
 
             Token newToken(TokenType::INTEGER_LITERAL, QString::number(sum), 0, 0);
@@ -86,7 +93,7 @@ void CodeGenerator::optimizeTokens() {
             changesMade = true;
         }
         else {
-            optimized.append(tokens[i]);
+            optimized.append(tokens, i);
         }
     }
 
@@ -132,7 +139,7 @@ QString CodeGenerator::translateToJava() {
             advance();  
             Token funcName = peek();
 
-            if (funcName.getLexeme() == "main") {
+            if (funcName.getLexemeView() == QLatin1String("main")) {
                 hasMain = true;
                 break;
             }
@@ -225,16 +232,16 @@ QString CodeGenerator::translateToAssembly() {
                 text_section += QString("    ; %1 = %2 %3 %4\n").arg(varName).arg(lhs.getLexeme()).arg(op.getLexeme()).arg(rhs.getLexeme());
                 text_section += QString("    mov eax, %1\n").arg(lhs_operand);
 
-                if (op.getLexeme() == "+") {
+                if (op.getLexemeView() == QLatin1String("+")) {
                     text_section += QString("    add eax, %1\n").arg(rhs_operand);
-                } else if (op.getLexeme() == "-") {
+                } else if (op.getLexemeView() == QLatin1String("-")) {
                     text_section += QString("    sub eax, %1\n").arg(rhs_operand);
                 }
                 text_section += QString("    mov [%1], eax\n\n").arg(varName);
             }
             match(TokenType::SEMICOLON);
         }
-        else if (tok.getType() == TokenType::KEYWORD && tok.getLexeme() == "return") {
+        else if (tok.getType() == TokenType::KEYWORD && tok.getLexemeView() == QLatin1String("return")) {
             advance(); 
             Token retVal = advance(); 
             match(TokenType::SEMICOLON);
@@ -274,7 +281,7 @@ void CodeGenerator::processStatement(QString& code) {
      
     if (lexeme == "using") {
         advance();  
-        if (peek().getLexeme() == "namespace") {
+        if (peek().getLexemeView() == QLatin1String("namespace")) {
             advance();  
             advance();  
             match(TokenType::SEMICOLON);
@@ -422,16 +429,13 @@ bool CodeGenerator::isFunctionDeclaration() const {
      
     int pos = currentPosition;
 
-    Token first = tokens[pos];
-    if (!isTypeKeyword(first.getLexeme())) return false;
+    if (!isTypeKeyword(tokens.lexemeAt(pos).toString())) return false;
 
     if (pos + 1 >= tokens.size()) return false;
-    Token second = tokens[pos + 1];
-    if (second.getType() != TokenType::IDENTIFIER) return false;
+    if (tokens.typeAt(pos + 1) != TokenType::IDENTIFIER) return false;
 
     if (pos + 2 >= tokens.size()) return false;
-    Token third = tokens[pos + 2];
-    return third.getType() == TokenType::LPAREN;
+    return tokens.typeAt(pos + 2) == TokenType::LPAREN;
 }
 
 void CodeGenerator::processFunctionDeclaration(QString& code) {
@@ -474,7 +478,7 @@ void CodeGenerator::processFunctionDeclaration(QString& code) {
     if (targetLanguage == TargetLanguage::PYTHON) {
         code += QString("def %1(%2):\n").arg(funcName.getLexeme()).arg(params.join(", "));
     } else if (targetLanguage == TargetLanguage::JAVA) {
-        QString modifier = (funcName.getLexeme() == "main") ? "public static " : "public static ";
+        QString modifier = (funcName.getLexemeView() == QLatin1String("main")) ? "public static " : "public static ";
         code += QString("%1%2 %3(%4) {\n")
                     .arg(modifier)
                     .arg(mapType(returnType.getLexeme()))
@@ -519,14 +523,14 @@ void CodeGenerator::processCout(QString& code) {
         QStringList parts;
 
         while (!check(TokenType::SEMICOLON) && !isAtEnd()) {
-            if (peek().getLexeme() == "<<") {
+            if (peek().getLexemeView() == QLatin1String("<<")) {
                 advance();
                 continue;
             }
 
             Token t = peek();
 
-            if (t.getLexeme() == "endl") {
+            if (t.getLexemeView() == QLatin1String("endl")) {
                 advance();
                  
                 continue;
@@ -536,7 +540,7 @@ void CodeGenerator::processCout(QString& code) {
                 parts.append(advance().getLexeme());
             } else {
                 QString expr;
-                while (!check(TokenType::SEMICOLON) && peek().getLexeme() != "<<" && !isAtEnd()) {
+                while (!check(TokenType::SEMICOLON) && peek().getLexemeView() != QLatin1String("<<") && !isAtEnd()) {
                     expr += advance().getLexeme();
                 }
                 if (!expr.isEmpty()) {
@@ -554,21 +558,21 @@ void CodeGenerator::processCout(QString& code) {
         bool hasEndl = false;
 
         while (!check(TokenType::SEMICOLON) && !isAtEnd()) {
-            if (peek().getLexeme() == "<<") {
+            if (peek().getLexemeView() == QLatin1String("<<")) {
                 advance();
                 continue;
             }
 
             Token t = peek();
 
-            if (t.getLexeme() == "endl") {
+            if (t.getLexemeView() == QLatin1String("endl")) {
                 hasEndl = true;
                 advance();
                 continue;
             }
 
             QString expr;
-            while (!check(TokenType::SEMICOLON) && peek().getLexeme() != "<<" && !isAtEnd()) {
+            while (!check(TokenType::SEMICOLON) && peek().getLexemeView() != QLatin1String("<<") && !isAtEnd()) {
                 expr += advance().getLexeme() + " ";
             }
             if (!expr.isEmpty()) {
@@ -588,20 +592,20 @@ void CodeGenerator::processCout(QString& code) {
         QStringList parts;
 
         while (!check(TokenType::SEMICOLON) && !isAtEnd()) {
-            if (peek().getLexeme() == "<<") {
+            if (peek().getLexemeView() == QLatin1String("<<")) {
                 advance();
                 continue;
             }
 
             Token t = peek();
 
-            if (t.getLexeme() == "endl") {
+            if (t.getLexemeView() == QLatin1String("endl")) {
                 advance();
                 continue;
             }
 
             QString expr;
-            while (!check(TokenType::SEMICOLON) && peek().getLexeme() != "<<" && !isAtEnd()) {
+            while (!check(TokenType::SEMICOLON) && peek().getLexemeView() != QLatin1String("<<") && !isAtEnd()) {
                 expr += advance().getLexeme() + " ";
             }
             if (!expr.isEmpty()) {
@@ -622,7 +626,7 @@ void CodeGenerator::processCin(QString& code) {
     QStringList vars;
 
     while (!check(TokenType::SEMICOLON) && !isAtEnd()) {
-        if (peek().getLexeme() == ">>") {
+        if (peek().getLexemeView() == QLatin1String(">>")) {
             advance();
             continue;
         }
@@ -681,7 +685,7 @@ void CodeGenerator::processPreprocessor(QString& code) {
     }
 
      
-    while (!isAtEnd() && peek().getLexeme() != "\n") {
+    while (!isAtEnd() && peek().getLexemeView() != QLatin1String("\n")) {
         if (check(TokenType::KEYWORD) || check(TokenType::IDENTIFIER)) break;
         advance();
     }
@@ -717,11 +721,11 @@ void CodeGenerator::processIfStatement(QString& code) {
     }
 
      
-    if (check(TokenType::KEYWORD) && peek().getLexeme() == "else") {
+    if (check(TokenType::KEYWORD) && peek().getLexemeView() == QLatin1String("else")) {
         advance();
         code += getIndent();
 
-        if (check(TokenType::KEYWORD) && peek().getLexeme() == "if") {
+        if (check(TokenType::KEYWORD) && peek().getLexemeView() == QLatin1String("if")) {
             if (targetLanguage == TargetLanguage::PYTHON) code += "el";
             else code += "else ";
             processIfStatement(code);
@@ -1077,7 +1081,7 @@ bool CodeGenerator::match(TokenType type) {
 
 bool CodeGenerator::check(TokenType type) const {
     if (isAtEnd()) return false;
-    return tokens[currentPosition].getType() == type;
+    return tokens.typeAt(currentPosition) == type;
 }
 
 bool CodeGenerator::isAtEnd() const {
@@ -1086,6 +1090,6 @@ bool CodeGenerator::isAtEnd() const {
 
 bool CodeGenerator::isControlStructure() const {
     if (isAtEnd()) return false;
-    QString lex = tokens[currentPosition].getLexeme().toLower();
+    QString lex = tokens.lexemeAt(currentPosition).toString().toLower();
     return lex == "if" || lex == "while" || lex == "for";
 }
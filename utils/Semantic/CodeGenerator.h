@@ -2,6 +2,7 @@
 #define CODEGENERATOR_H
 
 #include "./models/LexicalAnalysis/Token.h"
+#include "./models/LexicalAnalysis/TokenStream.h"
 #include "./models/Semantic/SymbolTable.h"
 #include <QString>
 #include <QVector>
@@ -16,7 +17,7 @@ enum class TargetLanguage {
 
 class CodeGenerator {
 private:
-    QVector<Token> tokens;
+    TokenStream tokens;
     SymbolTable* symbolTable;
     TargetLanguage targetLanguage;
     QString generatedCode;
@@ -33,6 +34,7 @@ public:
     ~CodeGenerator();
 
     void setTokens(const QVector<Token>& toks);
+    void setTokens(const TokenStream& toks);
     void setSymbolTable(SymbolTable* table);
     void setTargetLanguage(TargetLanguage lang);
 
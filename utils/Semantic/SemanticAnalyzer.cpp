@@ -16,14 +16,25 @@ SemanticAnalyzer::~SemanticAnalyzer() {
 }
 
 void SemanticAnalyzer::setTokens(const QVector<Token>& toks) {
+    tokens = TokenStream(toks);
+    currentPosition = 0;
+}
+
+void SemanticAnalyzer::setTokens(const TokenStream& toks) {
     tokens = toks;
     currentPosition = 0;
 }
 
+void SemanticAnalyzer::setLexer(Lexer* lexer) {
+    tokens = TokenReader(lexer);
+    currentPosition = 0;
+}
+
 void SemanticAnalyzer::reset() {
     symbolTable->clear();
     errors.clear();
     warnings.clear();
+    tokens.rewind();
     currentPosition = 0;
     discoveredSymbols.clear();
     
@@ -339,21 +350,21 @@ bool SemanticAnalyzer::isTypeCompatible(SymbolType expected, SymbolType actual)
 
  
 Token SemanticAnalyzer::peek() const {
-    if (currentPosition >= tokens.size()) {
+    if (!tokens.has(currentPosition)) {
         return Token(TokenType::END_OF_FILE, "", 0, 0);
     }
     return tokens[currentPosition];
 }
 
 Token SemanticAnalyzer::peekNext() const {
-    if (currentPosition + 1 >= tokens.size()) {
+    if (!tokens.has(currentPosition + 1)) {
         return Token(TokenType::END_OF_FILE, "", 0, 0);
     }
     return tokens[currentPosition + 1];
 }
 
 Token SemanticAnalyzer::advance() {
-    if (currentPosition >= tokens.size()) {
+    if (!tokens.has(currentPosition)) {
         return Token(TokenType::END_OF_FILE, "", 0, 0);
     }
     return tokens[currentPosition++];
@@ -377,12 +388,12 @@ bool SemanticAnalyzer::expect(TokenType type, const QString& message) {
 }
 
 bool SemanticAnalyzer::check(TokenType type) const {
-    if (currentPosition >= tokens.size()) return false;
-    return tokens[currentPosition].getType() == type;
+    if (!tokens.has(currentPosition)) return false;
+    return tokens.typeAt(currentPosition) == type;
 }
 
 bool SemanticAnalyzer::isAtEnd() const {
-    return currentPosition >= tokens.size();
+    return !tokens.has(currentPosition);
 }
 
 void SemanticAnalyzer::addError(const QString& message, int line) {
@@ -396,8 +407,8 @@ void SemanticAnalyzer::addWarning(const QString& message, int line) {
 }
 
 int SemanticAnalyzer::getCurrentLine() const {
-    if (currentPosition >= tokens.size()) return 0;
-    return tokens[currentPosition].getLine();
+    if (!tokens.has(currentPosition)) return 0;
+    return tokens.lineAt(currentPosition);
 }
 
 void SemanticAnalyzer::analyzeIfStatement() {
@@ -414,7 +425,7 @@ void SemanticAnalyzer::analyzeIfStatement() {
         advance();  
         while (!isAtEnd() && !check(TokenType::RBRACE)) {
             Token tok = peek();
-            if (tok.getType() == TokenType::KEYWORD && (tok.getLexeme() == "int" || tok.getLexeme() == "bool")) {
+            if (tok.getType() == TokenType::KEYWORD && (tok.getLexemeView() == QLatin1String("int") || tok.getLexemeView() == QLatin1String("bool"))) {
                 analyzeDeclaration();
             } else {
                 advance();
@@ -433,8 +444,9 @@ bool SemanticAnalyzer::isTypeKeyword(const QString& keyword) const {
 }
 
 bool SemanticAnalyzer::isFunctionDeclaration() const {
-    if (peekNext().getType() == TokenType::IDENTIFIER &&
-        peekAhead(2).getType() == TokenType::LPAREN) {
+    if (tokens.has(currentPosition + 2) &&
+        tokens.typeAt(currentPosition + 1) == TokenType::IDENTIFIER &&
+        tokens.typeAt(currentPosition + 2) == TokenType::LPAREN) {
         return true;
     }
     return false;
@@ -442,7 +454,7 @@ bool SemanticAnalyzer::isFunctionDeclaration() const {
 
 Token SemanticAnalyzer::peekAhead(int offset) const {
     int pos = currentPosition + offset;
-    if (pos >= tokens.size()) {
+    if (!tokens.has(pos)) {
         return Token(TokenType::END_OF_FILE, "", 0, 0);
     }
     return tokens[pos];
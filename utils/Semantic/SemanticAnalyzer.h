@@ -4,6 +4,8 @@
 #include <QVector>
 #include <QString>
 #include "../models/LexicalAnalysis/Token.h"
+#include "../models/LexicalAnalysis/TokenStream.h"
+#include "./src/utils/LexicalAnalysis/TokenReader.h"
 #include "../models/Semantic/SymbolTable.h"
 #include "../models/Semantic/ASTNode.h"
 
@@ -24,7 +26,7 @@ struct SemanticError {
 
 class SemanticAnalyzer {
 private:
-    QVector<Token> tokens;
+    TokenReader tokens;
     SymbolTable* symbolTable;
     int currentPosition;
     QVector<SemanticError> errors;
@@ -65,6 +67,8 @@ public:
     ~SemanticAnalyzer();
 
     void setTokens(const QVector<Token>& toks);
+    void setTokens(const TokenStream& toks);
+    void setLexer(Lexer* lexer);
     void reset();
     bool analyzeProgram();
 